@@ -90,6 +90,13 @@ bool UBTDecorator_HasLoSTo::CalculateRawConditionValue(UBehaviorTreeComponent& O
 
 		if (bGotTarget== true )
 		{
+			// actor targets go through the controller's weapon trace and share its cached results, a location key can change every evaluation
+			AShooterAIController* ShooterController = Cast<AShooterAIController>(MyController);
+			if (EnemyActor && ShooterController)
+			{
+				return ShooterController->HasWeaponLOSToEnemy(EnemyActor, true);
+			}
+
 			if (LOSTrace(OwnerComp.GetOwner(), EnemyActor, TargetLocation) == true)
 			{
 				HasLOS = true;
@@ -117,6 +124,11 @@ bool UBTDecorator_HasLoSTo::LOSTrace(AActor* InActor, AActor* InEnemyActor, cons
 			const FVector StartLocation = MyBot->GetActorLocation();
 			FHitResult Hit(ForceInit);
 			GetWorld()->LineTraceSingleByChannel(Hit, StartLocation, EndLocation, COLLISION_WEAPON, TraceParams);
+
+			if (AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>())
+			{
+				GameMode->GetEnemyIndex().NotifyLOSTrace();
+			}
 			if (Hit.bBlockingHit == true)
 			{
 				// We hit something. If we have an actor supplied, just check if the hit actor is an enemy. If it is consider that 'has LOS'
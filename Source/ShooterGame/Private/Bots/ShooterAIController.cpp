@@ -11,6 +11,25 @@
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
 #include "Weapons/ShooterWeapon.h"
 
+static int32 MaxLOSCandidates = 0;
+FAutoConsoleVariableRef CVarMaxLOSCandidates(
+	TEXT("ShooterAI.MaxLOSCandidates"),
+	MaxLOSCandidates,
+	TEXT("Number of nearest enemies a bot traces against when looking for an enemy in sight. A limit can miss a visible enemy behind occluded nearer ones.")
+	TEXT("0: All enemies, nearest first"),
+	ECVF_Default);
+
+static float LOSCacheTime = 0.1f;
+FAutoConsoleVariableRef CVarLOSCacheTime(
+	TEXT("ShooterAI.LOSCacheTime"),
+	LOSCacheTime,
+	TEXT("How long (seconds) a bot reuses a line of sight result for the same target. Results are always reused within a frame.")
+	TEXT("-1: Disable the cache"),
+	ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("AI LOS Cache Hits"), STAT_AILOSCacheHits, STATGROUP_ShooterGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("AI LOS Cache Misses"), STAT_AILOSCacheMisses, STATGROUP_ShooterGame);
+
 AShooterAIController::AShooterAIController(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
  	BlackboardComp = ObjectInitializer.CreateDefaultSubobject<UBlackboardComponent>(this, TEXT("BlackBoardComp"));
@@ -67,74 +86,105 @@ void AShooterAIController::Respawn()
 void AShooterAIController::FindClosestEnemy()
 {
 	APawn* MyBot = GetPawn();
-	if (MyBot == NULL)
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (MyBot == NULL || GameMode == NULL)
 	{
 		return;
 	}
 
-	const FVector MyLoc = MyBot->GetActorLocation();
-	float BestDistSq = MAX_FLT;
-	AShooterCharacter* BestPawn = NULL;
+	TArray<AShooterCharacter*> Enemies;
+	GameMode->GetEnemyIndex().FindNearestEnemies(GetWorld(), this, MyBot->GetActorLocation(), 1, Enemies);
 
-	for (AShooterCharacter* TestPawn : TActorRange<AShooterCharacter>(GetWorld()))
+	if (Enemies.Num() > 0)
 	{
-		if (TestPawn->IsAlive() && TestPawn->IsEnemyFor(this))
+		SetEnemy(Enemies[0]);
+	}
+}
+
+bool AShooterAIController::FindClosestEnemyWithLOS(AShooterCharacter* ExcludeEnemy)
+{
+	bool bGotEnemy = false;
+	APawn* MyBot = GetPawn();
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (MyBot != NULL && GameMode != NULL)
+	{
+		TArray<AShooterCharacter*> Enemies;
+		GameMode->GetEnemyIndex().FindNearestEnemies(GetWorld(), this, MyBot->GetActorLocation(), MaxLOSCandidates, Enemies, ExcludeEnemy);
+
+		// enemies are sorted nearest first, so the first one in sight is the closest one in sight
+		for (AShooterCharacter* TestPawn : Enemies)
 		{
-			const float DistSq = (TestPawn->GetActorLocation() - MyLoc).SizeSquared();
-			if (DistSq < BestDistSq)
+			if (HasWeaponLOSToEnemy(TestPawn, true) == true)
 			{
-				BestDistSq = DistSq;
-				BestPawn = TestPawn;
+				SetEnemy(TestPawn);
+				bGotEnemy = true;
+				break;
 			}
 		}
 	}
+	return bGotEnemy;
+}
 
-	if (BestPawn)
+bool AShooterAIController::FindCachedLOS(const AActor* Target, EShooterLOSQuery Query, bool& bOutHasLOS) const
+{
+	if (LOSCacheTime >= 0.0f)
 	{
-		SetEnemy(BestPawn);
+		const FCachedLOS* Cached = LOSCache.Find(MakeTuple(TWeakObjectPtr<const AActor>(Target), Query));
+		if (Cached && (Cached->Frame == GFrameCounter || GetWorld()->GetTimeSeconds() - Cached->Time <= LOSCacheTime))
+		{
+			INC_DWORD_STAT(STAT_AILOSCacheHits);
+			bOutHasLOS = Cached->bHasLOS;
+			return true;
+		}
 	}
+
+	INC_DWORD_STAT(STAT_AILOSCacheMisses);
+	return false;
 }
 
-bool AShooterAIController::FindClosestEnemyWithLOS(AShooterCharacter* ExcludeEnemy)
+void AShooterAIController::StoreCachedLOS(const AActor* Target, EShooterLOSQuery Query, bool bHasLOS) const
 {
-	bool bGotEnemy = false;
-	APawn* MyBot = GetPawn();
-	if (MyBot != NULL)
+	if (LOSCacheTime < 0.0f)
 	{
-		const FVector MyLoc = MyBot->GetActorLocation();
-		float BestDistSq = MAX_FLT;
-		AShooterCharacter* BestPawn = NULL;
+		return;
+	}
 
-		for (AShooterCharacter* TestPawn : TActorRange<AShooterCharacter>(GetWorld()))
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+
+	// drop results for dead targets and ones too old to be used again
+	if (LOSCache.Num() >= 32)
+	{
+		for (auto It = LOSCache.CreateIterator(); It; ++It)
 		{
-			if (TestPawn != ExcludeEnemy && TestPawn->IsAlive() && TestPawn->IsEnemyFor(this))
+			if (!It.Key().Key.IsValid() || TimeSeconds - It.Value().Time > LOSCacheTime)
 			{
-				if (HasWeaponLOSToEnemy(TestPawn, true) == true)
-				{
-					const float DistSq = (TestPawn->GetActorLocation() - MyLoc).SizeSquared();
-					if (DistSq < BestDistSq)
-					{
-						BestDistSq = DistSq;
-						BestPawn = TestPawn;
-					}
-				}
+				It.RemoveCurrent();
 			}
 		}
-		if (BestPawn)
-		{
-			SetEnemy(BestPawn);
-			bGotEnemy = true;
-		}
 	}
-	return bGotEnemy;
+
+	FCachedLOS& Cached = LOSCache.FindOrAdd(MakeTuple(TWeakObjectPtr<const AActor>(Target), Query));
+	Cached.Frame = GFrameCounter;
+	Cached.Time = TimeSeconds;
+	Cached.bHasLOS = bHasLOS;
 }
 
 bool AShooterAIController::HasWeaponLOSToEnemy(AActor* InEnemyActor, const bool bAnyEnemy) const
 {
 	
 	AShooterBot* MyBot = Cast<AShooterBot>(GetPawn());
+	if (MyBot == NULL)
+	{
+		return false;
+	}
 
+	const EShooterLOSQuery Query = bAnyEnemy ? EShooterLOSQuery::WeaponAnyEnemy : EShooterLOSQuery::Weapon;
 	bool bHasLOS = false;
+	if (FindCachedLOS(InEnemyActor, Query, bHasLOS))
+	{
+		return bHasLOS;
+	}
+
 	// Perform trace to retrieve hit info
 	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(AIWeaponLosTrace), true, GetPawn());
 
@@ -145,6 +195,11 @@ bool AShooterAIController::HasWeaponLOSToEnemy(AActor* InEnemyActor, const bool
 	FHitResult Hit(ForceInit);
 	const FVector EndLocation = InEnemyActor->GetActorLocation();
 	GetWorld()->LineTraceSingleByChannel(Hit, StartLocation, EndLocation, COLLISION_WEAPON, TraceParams);
+
+	if (AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>())
+	{
+		GameMode->GetEnemyIndex().NotifyLOSTrace();
+	}
 	if (Hit.bBlockingHit == true)
 	{
 		// Theres a blocking hit - check if its our enemy actor
@@ -176,6 +231,7 @@ bool AShooterAIController::HasWeaponLOSToEnemy(AActor* InEnemyActor, const bool
 	}
 
 	
+	StoreCachedLOS(InEnemyActor, Query, bHasLOS);
 
 	return bHasLOS;
 }
@@ -193,10 +249,18 @@ void AShooterAIController::ShootEnemy()
 	AShooterCharacter* Enemy = GetEnemy();
 	if ( Enemy && ( Enemy->IsAlive() )&& (MyWeapon->GetCurrentAmmo() > 0) && ( MyWeapon->CanFire() == true ) )
 	{
-		if (LineOfSightTo(Enemy, MyBot->GetActorLocation()))
+		bool bHasLOS = false;
+		if (!FindCachedLOS(Enemy, EShooterLOSQuery::Controller, bHasLOS))
 		{
-			bCanShoot = true;
+			bHasLOS = LineOfSightTo(Enemy, MyBot->GetActorLocation());
+			if (AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>())
+			{
+				GameMode->GetEnemyIndex().NotifyLOSTrace();
+			}
+			StoreCachedLOS(Enemy, EShooterLOSQuery::Controller, bHasLOS);
 		}
+
+		bCanShoot = bHasLOS;
 	}
 
 	if (bCanShoot)
@@ -0,0 +1,174 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterEnemyIndex.h"
+#include "Bots/ShooterAIController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Index Update"), STAT_EnemyIndexUpdate, STATGROUP_ShooterGame);
+DECLARE_CYCLE_STAT(TEXT("Enemy Index Query"), STAT_EnemyIndexQuery, STATGROUP_ShooterGame);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("AI LOS Traces Per Bot Per Second"), STAT_AILOSTracesPerBotPerSecond, STATGROUP_ShooterGame);
+
+static float EnemyIndexCellSize = 2000.0f;
+FAutoConsoleVariableRef CVarEnemyIndexCellSize(
+	TEXT("ShooterAI.EnemyIndexCellSize"),
+	EnemyIndexCellSize,
+	TEXT("Size (uu) of the grid cells bots use to find nearby enemies."),
+	ECVF_Default);
+
+FShooterEnemyIndex::FShooterEnemyIndex()
+	: MinCell(0, 0)
+	, MaxCell(0, 0)
+	, CellSize(EnemyIndexCellSize)
+	, LastUpdateFrame(0)
+	, NumLOSTraces(0)
+	, LastStatTime(0.0f)
+{
+}
+
+FIntPoint FShooterEnemyIndex::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void FShooterEnemyIndex::UpdateIndex(UWorld* World)
+{
+	if (LastUpdateFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_EnemyIndexUpdate);
+
+	LastUpdateFrame = GFrameCounter;
+	CellSize = FMath::Max(100.0f, EnemyIndexCellSize);
+
+	Entries.Reset();
+	for (TMap<FIntPoint, TArray<int32>>::TIterator It(Cells); It; ++It)
+	{
+		It.Value().Reset();
+	}
+
+	MinCell = FIntPoint(MAX_int32, MAX_int32);
+	MaxCell = FIntPoint(MIN_int32, MIN_int32);
+
+	for (AShooterCharacter* TestPawn : TActorRange<AShooterCharacter>(World))
+	{
+		if (TestPawn->IsAlive())
+		{
+			FEntry& Entry = Entries.AddDefaulted_GetRef();
+			Entry.Character = TestPawn;
+			Entry.Location = TestPawn->GetActorLocation();
+
+			const FIntPoint Cell = GetCell(Entry.Location);
+			Cells.FindOrAdd(Cell).Add(Entries.Num() - 1);
+
+			MinCell = FIntPoint(FMath::Min(MinCell.X, Cell.X), FMath::Min(MinCell.Y, Cell.Y));
+			MaxCell = FIntPoint(FMath::Max(MaxCell.X, Cell.X), FMath::Max(MaxCell.Y, Cell.Y));
+		}
+	}
+
+	// drop cells that stayed empty so the map doesn't grow with every cell ever visited
+	for (TMap<FIntPoint, TArray<int32>>::TIterator It(Cells); It; ++It)
+	{
+		if (It.Value().Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// traces per bot per second, averaged over one second
+	const float TimeSeconds = World->GetTimeSeconds();
+	if (TimeSeconds - LastStatTime >= 1.0f)
+	{
+		int32 NumBots = 0;
+		for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
+		{
+			if (Cast<AShooterAIController>(It->Get()))
+			{
+				NumBots++;
+			}
+		}
+
+		SET_FLOAT_STAT(STAT_AILOSTracesPerBotPerSecond, NumBots > 0 ? NumLOSTraces / (NumBots * (TimeSeconds - LastStatTime)) : 0.0f);
+		NumLOSTraces = 0;
+		LastStatTime = TimeSeconds;
+	}
+}
+
+void FShooterEnemyIndex::FindNearestEnemies(UWorld* World, AController* ForController, const FVector& Location, int32 MaxResults, TArray<AShooterCharacter*>& OutEnemies, const AShooterCharacter* ExcludeEnemy)
+{
+	UpdateIndex(World);
+
+	SCOPE_CYCLE_COUNTER(STAT_EnemyIndexQuery);
+
+	OutEnemies.Reset();
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<TPair<float, AShooterCharacter*>, TInlineAllocator<16>> Found;
+
+	// search rings of cells around the query cell until nothing closer than the worst kept result can be left
+	const FIntPoint Center = GetCell(Location);
+	const int32 MaxRing = FMath::Max(
+		FMath::Max(FMath::Abs(MinCell.X - Center.X), FMath::Abs(MaxCell.X - Center.X)),
+		FMath::Max(FMath::Abs(MinCell.Y - Center.Y), FMath::Abs(MaxCell.Y - Center.Y)));
+
+	for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+	{
+		for (int32 X = Center.X - Ring; X <= Center.X + Ring; X++)
+		{
+			// only the border of the square is new in this ring
+			const int32 StepY = (X == Center.X - Ring || X == Center.X + Ring) ? 1 : FMath::Max(1, 2 * Ring);
+			for (int32 Y = Center.Y - Ring; Y <= Center.Y + Ring; Y += StepY)
+			{
+				const TArray<int32>* CellEntries = Cells.Find(FIntPoint(X, Y));
+				if (CellEntries == nullptr)
+				{
+					continue;
+				}
+
+				for (int32 EntryIndex : *CellEntries)
+				{
+					const FEntry& Entry = Entries[EntryIndex];
+					if (Entry.Character == ExcludeEnemy || !Entry.Character->IsAlive())
+					{
+						continue;
+					}
+
+					if (Entry.Character->IsEnemyFor(ForController))
+					{
+						Found.Emplace((Entry.Location - Location).SizeSquared(), Entry.Character);
+					}
+				}
+			}
+		}
+
+		if (MaxResults > 0 && Found.Num() >= MaxResults)
+		{
+			Found.Sort([](const TPair<float, AShooterCharacter*>& A, const TPair<float, AShooterCharacter*>& B) { return A.Key < B.Key; });
+
+			// every cell outside this ring is at least Ring cells away from the query location
+			const float MinUnsearchedDist = Ring * CellSize;
+			if (Found[MaxResults - 1].Key <= FMath::Square(MinUnsearchedDist))
+			{
+				break;
+			}
+		}
+	}
+
+	Found.Sort([](const TPair<float, AShooterCharacter*>& A, const TPair<float, AShooterCharacter*>& B) { return A.Key < B.Key; });
+
+	const int32 NumResults = MaxResults > 0 ? FMath::Min(MaxResults, Found.Num()) : Found.Num();
+	OutEnemies.Reserve(NumResults);
+	for (int32 Idx = 0; Idx < NumResults; Idx++)
+	{
+		OutEnemies.Add(Found[Idx].Value);
+	}
+}
+
+void FShooterEnemyIndex::NotifyLOSTrace()
+{
+	NumLOSTraces++;
+}
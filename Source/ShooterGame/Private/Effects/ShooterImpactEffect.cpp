@@ -12,33 +12,41 @@ void AShooterImpactEffect::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 
-	UPhysicalMaterial* HitPhysMat = SurfaceHit.PhysMaterial.Get();
+	PlayImpact(GetWorld(), GetActorLocation(), GetActorRotation(), SurfaceHit, true, true);
+}
+
+UDecalComponent* AShooterImpactEffect::PlayImpact(UWorld* World, const FVector& Location, const FRotator& Rotation, const FHitResult& Hit, bool bPlaySound, bool bSpawnDecal) const
+{
+	UPhysicalMaterial* HitPhysMat = Hit.PhysMaterial.Get();
 	EPhysicalSurface HitSurfaceType = UPhysicalMaterial::DetermineSurfaceType(HitPhysMat);
 
 	// show particles
 	UParticleSystem* ImpactFX = GetImpactFX(HitSurfaceType);
 	if (ImpactFX)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(this, ImpactFX, GetActorLocation(), GetActorRotation());
+		UGameplayStatics::SpawnEmitterAtLocation(World, ImpactFX, Location, Rotation);
 	}
 
 	// play sound
-	USoundCue* ImpactSound = GetImpactSound(HitSurfaceType);
+	USoundCue* ImpactSound = bPlaySound ? GetImpactSound(HitSurfaceType) : NULL;
 	if (ImpactSound)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
+		UGameplayStatics::PlaySoundAtLocation(World, ImpactSound, Location);
 	}
 
-	if (DefaultDecal.DecalMaterial)
+	UDecalComponent* Decal = NULL;
+	if (bSpawnDecal && DefaultDecal.DecalMaterial)
 	{
-		FRotator RandomDecalRotation = SurfaceHit.ImpactNormal.Rotation();
+		FRotator RandomDecalRotation = Hit.ImpactNormal.Rotation();
 		RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
 
-		UGameplayStatics::SpawnDecalAttached(DefaultDecal.DecalMaterial, FVector(1.0f, DefaultDecal.DecalSize, DefaultDecal.DecalSize),
-			SurfaceHit.Component.Get(), SurfaceHit.BoneName,
-			SurfaceHit.ImpactPoint, RandomDecalRotation, EAttachLocation::KeepWorldPosition,
+		Decal = UGameplayStatics::SpawnDecalAttached(DefaultDecal.DecalMaterial, FVector(1.0f, DefaultDecal.DecalSize, DefaultDecal.DecalSize),
+			Hit.Component.Get(), Hit.BoneName,
+			Hit.ImpactPoint, RandomDecalRotation, EAttachLocation::KeepWorldPosition,
 			DefaultDecal.LifeSpan);
 	}
+
+	return Decal;
 }
 
 UParticleSystem* AShooterImpactEffect::GetImpactFX(TEnumAsByte<EPhysicalSurface> SurfaceType) const
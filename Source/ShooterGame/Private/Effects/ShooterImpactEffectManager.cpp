@@ -0,0 +1,242 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Effects/ShooterImpactEffectManager.h"
+#include "Effects/ShooterImpactEffect.h"
+#include "Components/DecalComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Impact Effects"), STAT_ImpactEffects, STATGROUP_ShooterGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Impact Effects Pending"), STAT_ImpactEffectsPending, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact Effects Played"), STAT_ImpactEffectsPlayed, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact Effects Coalesced"), STAT_ImpactEffectsCoalesced, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact Effects Culled"), STAT_ImpactEffectsCulled, STATGROUP_ShooterGame);
+
+static int32 PooledImpactEffects = 0;
+FAutoConsoleVariableRef CVarPooledImpactEffects(
+	TEXT("ShooterWeapon.PooledImpactEffects"),
+	PooledImpactEffects,
+	TEXT("Play instant hit impact effects from queued records instead of spawning an actor per hit.")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static int32 ImpactEffectBudget = 4;
+FAutoConsoleVariableRef CVarImpactEffectBudget(
+	TEXT("ShooterWeapon.ImpactEffectBudget"),
+	ImpactEffectBudget,
+	TEXT("Maximum number of impact effects played per frame."),
+	ECVF_Default);
+
+static float ImpactEffectMaxDelay = 0.25f;
+FAutoConsoleVariableRef CVarImpactEffectMaxDelay(
+	TEXT("ShooterWeapon.ImpactEffectMaxDelay"),
+	ImpactEffectMaxDelay,
+	TEXT("Impacts waiting longer than this (seconds) are dropped."),
+	ECVF_Default);
+
+static float ImpactEffectCoalesceDistance = 30.0f;
+FAutoConsoleVariableRef CVarImpactEffectCoalesceDistance(
+	TEXT("ShooterWeapon.ImpactEffectCoalesceDistance"),
+	ImpactEffectCoalesceDistance,
+	TEXT("Pending impacts on the same surface closer than this are played once."),
+	ECVF_Default);
+
+static float ImpactEffectDecalDistance = 3000.0f;
+FAutoConsoleVariableRef CVarImpactEffectDecalDistance(
+	TEXT("ShooterWeapon.ImpactEffectDecalDistance"),
+	ImpactEffectDecalDistance,
+	TEXT("Impacts further than this from every local view don't spawn a decal."),
+	ECVF_Default);
+
+static float ImpactEffectSoundDistance = 5000.0f;
+FAutoConsoleVariableRef CVarImpactEffectSoundDistance(
+	TEXT("ShooterWeapon.ImpactEffectSoundDistance"),
+	ImpactEffectSoundDistance,
+	TEXT("Impacts further than this from every local view don't play a sound."),
+	ECVF_Default);
+
+static float ImpactEffectCullDistance = 8000.0f;
+FAutoConsoleVariableRef CVarImpactEffectCullDistance(
+	TEXT("ShooterWeapon.ImpactEffectCullDistance"),
+	ImpactEffectCullDistance,
+	TEXT("Impacts further than this from every local view are not played."),
+	ECVF_Default);
+
+static int32 ImpactEffectMaxDecals = 64;
+FAutoConsoleVariableRef CVarImpactEffectMaxDecals(
+	TEXT("ShooterWeapon.ImpactEffectMaxDecals"),
+	ImpactEffectMaxDecals,
+	TEXT("Maximum number of impact decals, the oldest are removed first."),
+	ECVF_Default);
+
+/** upper limit of pending impacts, the oldest are dropped first */
+static const int32 MaxPendingImpacts = 64;
+
+AShooterImpactEffectManager::AShooterImpactEffectManager(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+	bReplicates = false;
+
+	PendingImpacts.Reserve(MaxPendingImpacts);
+}
+
+AShooterImpactEffectManager* AShooterImpactEffectManager::Get(UWorld* World)
+{
+	for (AShooterImpactEffectManager* Manager : TActorRange<AShooterImpactEffectManager>(World))
+	{
+		return Manager;
+	}
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.ObjectFlags |= RF_Transient;
+	return World->SpawnActor<AShooterImpactEffectManager>(SpawnInfo);
+}
+
+bool AShooterImpactEffectManager::IsEnabled()
+{
+	return PooledImpactEffects != 0;
+}
+
+void AShooterImpactEffectManager::QueueImpact(TSubclassOf<AShooterImpactEffect> ImpactTemplate, const FHitResult& Impact)
+{
+	const AShooterImpactEffect* Template = ImpactTemplate->GetDefaultObject<AShooterImpactEffect>();
+	UPrimitiveComponent* HitComponent = Impact.Component.Get();
+
+	// a burst hitting the same spot only needs one effect
+	const float CoalesceDistanceSq = FMath::Square(ImpactEffectCoalesceDistance);
+	for (const FShooterImpactRecord& Pending : PendingImpacts)
+	{
+		if (Pending.Template == Template && Pending.Component.Get() == HitComponent &&
+			FVector::DistSquared(Pending.Location, Impact.ImpactPoint) < CoalesceDistanceSq)
+		{
+			INC_DWORD_STAT(STAT_ImpactEffectsCoalesced);
+			return;
+		}
+	}
+
+	if (PendingImpacts.Num() >= MaxPendingImpacts)
+	{
+		PendingImpacts.RemoveAt(0, 1, false);
+	}
+
+	FShooterImpactRecord& Record = PendingImpacts.AddDefaulted_GetRef();
+	Record.Template = Template;
+	Record.Location = Impact.ImpactPoint;
+	Record.Normal = Impact.ImpactNormal;
+	Record.Component = Impact.Component;
+	Record.BoneName = Impact.BoneName;
+	Record.PhysMaterial = Impact.PhysMaterial;
+	Record.QueuedTime = GetWorld()->GetTimeSeconds();
+}
+
+void AShooterImpactEffectManager::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	SCOPE_CYCLE_COUNTER(STAT_ImpactEffects);
+	SET_DWORD_STAT(STAT_ImpactEffectsPending, PendingImpacts.Num());
+
+	if (PendingImpacts.Num() == 0)
+	{
+		return;
+	}
+
+	// drop impacts which waited too long to still look like a response to the shot
+	const float MinQueuedTime = GetWorld()->GetTimeSeconds() - ImpactEffectMaxDelay;
+	int32 NumStale = 0;
+	while (NumStale < PendingImpacts.Num() && PendingImpacts[NumStale].QueuedTime < MinQueuedTime)
+	{
+		NumStale++;
+	}
+	INC_DWORD_STAT_BY(STAT_ImpactEffectsCulled, NumStale);
+
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+
+	const int32 NumPlayed = FMath::Min(PendingImpacts.Num() - NumStale, FMath::Max(ImpactEffectBudget, 1));
+	for (int32 Idx = NumStale; Idx < NumStale + NumPlayed; Idx++)
+	{
+		PlayRecord(PendingImpacts[Idx], ViewLocations);
+	}
+
+	PendingImpacts.RemoveAt(0, NumStale + NumPlayed, false);
+}
+
+void AShooterImpactEffectManager::PlayRecord(const FShooterImpactRecord& Record, TArrayView<const FVector> ViewLocations)
+{
+	float MinDistanceSq = MAX_FLT;
+	for (const FVector& ViewLocation : ViewLocations)
+	{
+		MinDistanceSq = FMath::Min(MinDistanceSq, FVector::DistSquared(ViewLocation, Record.Location));
+	}
+
+	if (MinDistanceSq > FMath::Square(ImpactEffectCullDistance))
+	{
+		INC_DWORD_STAT(STAT_ImpactEffectsCulled);
+		return;
+	}
+
+	const bool bSpawnDecal = (MinDistanceSq <= FMath::Square(ImpactEffectDecalDistance));
+	const bool bPlaySound = (MinDistanceSq <= FMath::Square(ImpactEffectSoundDistance));
+
+	FHitResult Hit;
+	Hit.bBlockingHit = true;
+	Hit.Location = Record.Location;
+	Hit.ImpactPoint = Record.Location;
+	Hit.Normal = Record.Normal;
+	Hit.ImpactNormal = Record.Normal;
+	Hit.Component = Record.Component;
+	Hit.BoneName = Record.BoneName;
+	Hit.PhysMaterial = Record.PhysMaterial;
+
+	// trace again to find component lost during replication, only needed close enough for a decal
+	if (bSpawnDecal && !Hit.Component.IsValid())
+	{
+		static FName ImpactTraceTag = FName(TEXT("ImpactEffectTrace"));
+		FCollisionQueryParams TraceParams(ImpactTraceTag, true);
+		TraceParams.bReturnPhysicalMaterial = true;
+
+		const FVector StartTrace = Record.Location + Record.Normal * 10.0f;
+		const FVector EndTrace = Record.Location - Record.Normal * 10.0f;
+		FHitResult TraceHit;
+		if (GetWorld()->LineTraceSingleByChannel(TraceHit, StartTrace, EndTrace, COLLISION_WEAPON, TraceParams))
+		{
+			Hit = TraceHit;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_ImpactEffectsPlayed);
+
+	UDecalComponent* Decal = Record.Template->PlayImpact(GetWorld(), Record.Location, Record.Normal.Rotation(), Hit, bPlaySound, bSpawnDecal);
+	if (Decal)
+	{
+		AddDecal(Decal);
+	}
+}
+
+void AShooterImpactEffectManager::AddDecal(UDecalComponent* Decal)
+{
+	ActiveDecals.RemoveAll([](const TWeakObjectPtr<UDecalComponent>& ActiveDecal) { return !ActiveDecal.IsValid(); });
+
+	const int32 NumOverLimit = ActiveDecals.Num() + 1 - FMath::Max(ImpactEffectMaxDecals, 1);
+	for (int32 Idx = 0; Idx < NumOverLimit; Idx++)
+	{
+		ActiveDecals[Idx]->DestroyComponent();
+	}
+	if (NumOverLimit > 0)
+	{
+		ActiveDecals.RemoveAt(0, NumOverLimit, false);
+	}
+
+	ActiveDecals.Add(Decal);
+}
@@ -10,6 +10,7 @@
 #include "Online/ShooterGameSession.h"
 #include "Bots/ShooterAIController.h"
 #include "ShooterTeamStart.h"
+#include "Weapons/ShooterProjectile.h"
 
 
 AShooterGameMode::AShooterGameMode(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -386,6 +387,12 @@ void AShooterGameMode::RestartPlayer(AController* NewPlayer)
 
 AActor* AShooterGameMode::ChoosePlayerStart_Implementation(AController* Player)
 {
+	if (FShooterSpawnSelector::IsEnabled())
+	{
+		APlayerStart* SelectedStart = SpawnSelector.ChooseStart(this, Player);
+		return SelectedStart ? SelectedStart : Super::ChoosePlayerStart_Implementation(Player);
+	}
+
 	TArray<APlayerStart*> PreferredSpawns;
 	TArray<APlayerStart*> FallbackSpawns;
 
@@ -569,3 +576,77 @@ void AShooterGameMode::RestartGame()
 	Super::RestartGame();
 }
 
+AShooterProjectile* AShooterGameMode::AcquireProjectile(TSubclassOf<AShooterProjectile> ProjectileClass)
+{
+	for (int32 Idx = ProjectilePool.Num() - 1; Idx >= 0; Idx--)
+	{
+		AShooterProjectile* Projectile = ProjectilePool[Idx];
+		if (Projectile == NULL || Projectile->IsPendingKill())
+		{
+			ProjectilePool.RemoveAtSwap(Idx);
+		}
+		else if (Projectile->GetClass() == ProjectileClass)
+		{
+			ProjectilePool.RemoveAtSwap(Idx);
+			return Projectile;
+		}
+	}
+
+	return NULL;
+}
+
+void AShooterGameMode::ReleaseProjectile(AShooterProjectile* Projectile)
+{
+	const int32* PoolSize = ProjectilePoolSizes.Find(Projectile->GetClass());
+	if (PoolSize && !ProjectilePool.Contains(Projectile))
+	{
+		int32 NumPooled = 0;
+		for (AShooterProjectile* PooledProjectile : ProjectilePool)
+		{
+			if (PooledProjectile && PooledProjectile->GetClass() == Projectile->GetClass())
+			{
+				NumPooled++;
+			}
+		}
+
+		// more were in flight at once than prewarmed, don't keep the extra ones idle
+		if (NumPooled >= *PoolSize)
+		{
+			Projectile->SetPooled(false);
+			Projectile->Destroy();
+			return;
+		}
+	}
+
+	Projectile->DeactivateToPool();
+	ProjectilePool.AddUnique(Projectile);
+}
+
+void AShooterGameMode::PrewarmProjectiles(TSubclassOf<AShooterProjectile> ProjectileClass, int32 Count)
+{
+	int32& PoolSize = ProjectilePoolSizes.FindOrAdd(ProjectileClass);
+	PoolSize = FMath::Max(PoolSize, Count);
+
+	int32 NumPooled = 0;
+	for (AShooterProjectile* Projectile : ProjectilePool)
+	{
+		if (Projectile && Projectile->GetClass() == ProjectileClass)
+		{
+			NumPooled++;
+		}
+	}
+
+	// park them far above the level, they are moved to the muzzle when fired
+	const FTransform ParkingTM(FVector(0.0f, 0.0f, HALF_WORLD_MAX * 0.5f));
+
+	for (; NumPooled < Count; NumPooled++)
+	{
+		AShooterProjectile* Projectile = AShooterProjectile::SpawnPooled(GetWorld(), ProjectileClass, ParkingTM, true);
+		if (Projectile == NULL)
+		{
+			break;
+		}
+
+		ReleaseProjectile(Projectile);
+	}
+}
@@ -9,6 +9,8 @@ AShooterGameState::AShooterGameState(const FObjectInitializer& ObjectInitializer
 	NumTeams = 0;
 	RemainingTime = 0;
 	bTimerPaused = false;
+	bRankedTeamsDirty = true;
+	RankingVersion = 0;
 }
 
 void AShooterGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & OutLifetimeProps ) const
@@ -19,38 +21,136 @@ void AShooterGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty >
 	DOREPLIFETIME( AShooterGameState, RemainingTime );
 	DOREPLIFETIME( AShooterGameState, bTimerPaused );
 	DOREPLIFETIME( AShooterGameState, TeamScores );
+	DOREPLIFETIME( AShooterGameState, ScoreboardStats );
 }
 
 void AShooterGameState::GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const
 {
-	OutRankedMap.Empty();
+	OutRankedMap = GetCachedRankedMap(TeamIndex);
+}
+
+const RankedPlayerMap& AShooterGameState::GetCachedRankedMap(int32 TeamIndex) const
+{
+	UpdateRankings();
 
-	//first, we need to go over all the PlayerStates, grab their score, and rank them
-	TMultiMap<int32, AShooterPlayerState*> SortedMap;
-	for(int32 i = 0; i < PlayerArray.Num(); ++i)
+	static const RankedPlayerMap EmptyMap;
+	return RankedMaps.IsValidIndex(TeamIndex) ? RankedMaps[TeamIndex] : EmptyMap;
+}
+
+void AShooterGameState::NotifyPlayerScoreChanged(AShooterPlayerState* PlayerState)
+{
+	const int32 TeamIndex = PlayerState->GetTeamNum();
+	if (DirtyTeams.IsValidIndex(TeamIndex))
 	{
-		int32 Score = 0;
-		AShooterPlayerState* CurPlayerState = Cast<AShooterPlayerState>(PlayerArray[i]);
-		if (CurPlayerState && (CurPlayerState->GetTeamNum() == TeamIndex))
-		{
-			SortedMap.Add(FMath::TruncToInt(CurPlayerState->Score), CurPlayerState);
-		}
+		DirtyTeams[TeamIndex] = true;
+	}
+	else
+	{
+		bRankedTeamsDirty = true;
 	}
 
-	//sort by the keys
-	SortedMap.KeySort(TGreater<int32>());
+	RankingVersion++;
+}
+
+void AShooterGameState::NotifyPlayerTeamsChanged()
+{
+	bRankedTeamsDirty = true;
+	RankingVersion++;
+}
+
+void AShooterGameState::AddPlayerState(APlayerState* PlayerState)
+{
+	Super::AddPlayerState(PlayerState);
+
+	AShooterPlayerState* ShooterPlayerState = Cast<AShooterPlayerState>(PlayerState);
+	if (ShooterPlayerState)
+	{
+		UpdateScoreboardStats(ShooterPlayerState);
+	}
+
+	NotifyPlayerTeamsChanged();
+}
+
+void AShooterGameState::RemovePlayerState(APlayerState* PlayerState)
+{
+	Super::RemovePlayerState(PlayerState);
+
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		ScoreboardStats.RemovePlayer(Cast<AShooterPlayerState>(PlayerState));
+	}
 
-	//now, add them back to the ranked map
-	OutRankedMap.Empty();
+	NotifyPlayerTeamsChanged();
+}
 
-	int32 Rank = 0;
-	for(TMultiMap<int32, AShooterPlayerState*>::TIterator It(SortedMap); It; ++It)
+void AShooterGameState::UpdateScoreboardStats(AShooterPlayerState* PlayerState)
+{
+	if (GetLocalRole() == ROLE_Authority)
 	{
-		OutRankedMap.Add(Rank++, It.Value());
+		ScoreboardStats.UpdatePlayer(PlayerState);
 	}
-	
 }
 
+void AShooterGameState::UpdateRankings() const
+{
+	if (bRankedTeamsDirty)
+	{
+		bRankedTeamsDirty = false;
+
+		int32 NumRankedTeams = FMath::Max(NumTeams, 1);
+		for (APlayerState* PlayerState : PlayerArray)
+		{
+			AShooterPlayerState* CurPlayerState = Cast<AShooterPlayerState>(PlayerState);
+			if (CurPlayerState)
+			{
+				NumRankedTeams = FMath::Max(NumRankedTeams, CurPlayerState->GetTeamNum() + 1);
+			}
+		}
+
+		RankedPlayers.SetNum(NumRankedTeams);
+		RankedMaps.SetNum(NumRankedTeams);
+		DirtyTeams.Init(true, NumRankedTeams);
+
+		for (TArray<TWeakObjectPtr<AShooterPlayerState>>& TeamPlayers : RankedPlayers)
+		{
+			TeamPlayers.Reset();
+		}
+
+		for (APlayerState* PlayerState : PlayerArray)
+		{
+			AShooterPlayerState* CurPlayerState = Cast<AShooterPlayerState>(PlayerState);
+			if (CurPlayerState && CurPlayerState->GetTeamNum() >= 0)
+			{
+				RankedPlayers[CurPlayerState->GetTeamNum()].Add(CurPlayerState);
+			}
+		}
+	}
+
+	for (TConstSetBitIterator<> It(DirtyTeams); It; ++It)
+	{
+		const int32 TeamIndex = It.GetIndex();
+		TArray<TWeakObjectPtr<AShooterPlayerState>>& TeamPlayers = RankedPlayers[TeamIndex];
+
+		TeamPlayers.RemoveAll([](const TWeakObjectPtr<AShooterPlayerState>& PlayerState) { return !PlayerState.IsValid(); });
+
+		// stable so tied players keep their rows between updates
+		TeamPlayers.StableSort([](const TWeakObjectPtr<AShooterPlayerState>& A, const TWeakObjectPtr<AShooterPlayerState>& B)
+		{
+			return FMath::TruncToInt(A->Score) > FMath::TruncToInt(B->Score);
+		});
+
+		RankedPlayerMap& RankedMap = RankedMaps[TeamIndex];
+		RankedMap.Reset();
+
+		int32 Rank = 0;
+		for (const TWeakObjectPtr<AShooterPlayerState>& PlayerState : TeamPlayers)
+		{
+			RankedMap.Add(Rank++, PlayerState);
+		}
+	}
+
+	DirtyTeams.Init(false, DirtyTeams.Num());
+}
 
 void AShooterGameState::RequestFinishAndExitToMainMenu()
 {
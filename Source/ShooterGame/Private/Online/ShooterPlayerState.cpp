@@ -12,6 +12,8 @@ AShooterPlayerState::AShooterPlayerState(const FObjectInitializer& ObjectInitial
 	NumBulletsFired = 0;
 	NumRocketsFired = 0;
 	bQuitter = false;
+	LastVictimTime = 0.f;
+	LastKillerTime = 0.f;
 }
 
 void AShooterPlayerState::Reset()
@@ -25,6 +27,11 @@ void AShooterPlayerState::Reset()
 	NumBulletsFired = 0;
 	NumRocketsFired = 0;
 	bQuitter = false;
+	LastVictim = nullptr;
+	LastKiller = nullptr;
+
+	NotifyRankingChanged(true);
+	UpdateScoreboardStats();
 }
 
 void AShooterPlayerState::RegisterPlayerWithSession(bool bWasFromInvite)
@@ -55,21 +62,58 @@ void AShooterPlayerState::SetTeamNum(int32 NewTeamNumber)
 	TeamNumber = NewTeamNumber;
 
 	UpdateTeamColors();
+	NotifyRankingChanged(true);
+	UpdateScoreboardStats();
 }
 
 void AShooterPlayerState::OnRep_TeamColor()
 {
 	UpdateTeamColors();
+	NotifyRankingChanged(true);
+}
+
+void AShooterPlayerState::OnRep_Score()
+{
+	Super::OnRep_Score();
+
+	NotifyRankingChanged(false);
+}
+
+void AShooterPlayerState::UpdateScoreboardStats()
+{
+	AShooterGameState* const MyGameState = GetWorld() ? GetWorld()->GetGameState<AShooterGameState>() : NULL;
+	if (MyGameState)
+	{
+		MyGameState->UpdateScoreboardStats(this);
+	}
+}
+
+void AShooterPlayerState::NotifyRankingChanged(bool bTeamChanged)
+{
+	AShooterGameState* const MyGameState = GetWorld() ? GetWorld()->GetGameState<AShooterGameState>() : NULL;
+	if (MyGameState)
+	{
+		if (bTeamChanged)
+		{
+			MyGameState->NotifyPlayerTeamsChanged();
+		}
+		else
+		{
+			MyGameState->NotifyPlayerScoreChanged(this);
+		}
+	}
 }
 
 void AShooterPlayerState::AddBulletsFired(int32 NumBullets)
 {
 	NumBulletsFired += NumBullets;
+	UpdateScoreboardStats();
 }
 
 void AShooterPlayerState::AddRocketsFired(int32 NumRockets)
 {
 	NumRocketsFired += NumRockets;
+	UpdateScoreboardStats();
 }
 
 void AShooterPlayerState::SetQuitter(bool bInQuitter)
@@ -136,16 +180,34 @@ bool AShooterPlayerState::IsQuitter() const
 	return bQuitter;
 }
 
+bool AShooterPlayerState::HasRecentlyFought(const AShooterPlayerState* Other, float MaxAge) const
+{
+	if (Other == nullptr)
+	{
+		return false;
+	}
+
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+	return (LastVictim.Get() == Other && TimeSeconds - LastVictimTime <= MaxAge)
+		|| (LastKiller.Get() == Other && TimeSeconds - LastKillerTime <= MaxAge);
+}
+
 void AShooterPlayerState::ScoreKill(AShooterPlayerState* Victim, int32 Points)
 {
 	NumKills++;
 	ScorePoints(Points);
+
+	LastVictim = Victim;
+	LastVictimTime = GetWorld()->GetTimeSeconds();
 }
 
 void AShooterPlayerState::ScoreDeath(AShooterPlayerState* KilledBy, int32 Points)
 {
 	NumDeaths++;
 	ScorePoints(Points);
+
+	LastKiller = KilledBy;
+	LastKillerTime = GetWorld()->GetTimeSeconds();
 }
 
 void AShooterPlayerState::ScorePoints(int32 Points)
@@ -162,6 +224,8 @@ void AShooterPlayerState::ScorePoints(int32 Points)
 	}
 
 	Score += Points;
+	NotifyRankingChanged(false);
+	UpdateScoreboardStats();
 }
 
 void AShooterPlayerState::InformAboutKill_Implementation(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState)
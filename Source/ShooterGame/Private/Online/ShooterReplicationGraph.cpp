@@ -26,6 +26,7 @@
 *		UReplicationGraphNode_GridSpatialization2D: 
 *		This is the spatialization node. All "distance based relevant" actors will be routed here. This node divides the map into a 2D grid. Each cell in the grid contains 
 *		children nodes that hold lists of actors based on how they update/go dormant. Actors are put in multiple cells. Connections pull from the single cell they are in.
+*		The cell size and bias are derived from the level bounds and typical cull distance when the world is initialized (ShooterRepGraph.AutoGrid).
 *		
 *		UReplicationGraphNode_ActorList
 *		This is an actor list node that contains the always relevant actors. These actors are always relevant to every connection.
@@ -38,7 +39,12 @@
 *		UShooterReplicationGraphNode_PlayerStateFrequencyLimiter
 *		A custom node for handling player state replication. This replicates a small rolling set of player states (currently 2/frame). This is so player states replicate
 *		to simulated connections at a low, steady frequency, and to take advantage of serialization sharing. Auto proxy player states are replicated at higher frequency (to the
-*		owning connection only) via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection.
+*		owning connection only) via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection. Player states are routed to this node through the normal add/remove
+*		notifications, so the buckets are persistent and only touched when a player joins or leaves.
+*		
+*		UShooterReplicationGraphNode_TeamPawns
+*		Tracks every AShooterCharacter next to the GridNode. Teammate pawns are returned to each connection at a low, steady frequency with their cull distance cleared,
+*		so they stay up to date at any range. Enemy pawns get a per connection replication period that grows with their distance to the viewer.
 *		
 *		UReplicationGraphNode_TearOff_ForConnection
 *		Connection specific node for handling tear off actors. This is created and managed in the base implementation of Replication Graph.
@@ -49,7 +55,9 @@
 *		actor itself never goes into the Replication Graph. It is never gathered on its own and never prioritized. It just has a chance to replicate when the Pawn replicates. This keeps
 *		the graph leaner since no extra work has to be done for the weapon actors.
 *		
-*		See UShooterReplicationGraph::OnCharacterWeaponChange: this is how actors are added/removed from the dependent actor list. 
+*		See UShooterReplicationGraph::OnCharacterEquipWeapon/OnCharacterUnEquipWeapon: this is how actors are added/removed from the dependent actor list. 
+*		The owning connection also gets the rest of the inventory through UShooterReplicationGraphNode_AlwaysRelevant_ForConnection, whose list is only rebuilt
+*		when the viewer, pawn or inventory changes (see UShooterReplicationGraph::OnCharacterInventoryChange).
 *	
 *	How To Use
 *	
@@ -73,6 +81,8 @@
 *		Net.RepGraph.PrintAllActorInfo <ActorMatchString> - will print the class, global, and connection replication info associated with an actor/class. If MatchString is empty will print everything. Call directly from client.
 *		
 *		ShooterRepGraph.PrintRouting - will print the EClassRepNodeMapping for each class. That is, how a given actor class is routed (or not) in the Replication Graph.
+*		
+*		ShooterRepGraph.PrintGrid - will print the grid cell size and bias, how many actors the cells hold and the grid gather cost since the last call.
 *	
 */
 
@@ -93,6 +103,7 @@
 #include "GameFramework/PlayerState.h"
 #include "GameFramework/Pawn.h"
 #include "Engine/LevelScriptActor.h"
+#include "Engine/LevelBounds.h"
 #include "Player/ShooterCharacter.h"
 #include "Online/ShooterPlayerState.h"
 #include "Weapons/ShooterWeapon.h"
@@ -100,6 +111,11 @@
 
 DEFINE_LOG_CATEGORY( LogShooterReplicationGraph );
 
+DECLARE_CYCLE_STAT(TEXT("RepGraph Always Relevant Gather"), STAT_ShooterRepGraphAlwaysRelevantGather, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RepGraph Always Relevant Rebuilds"), STAT_ShooterRepGraphAlwaysRelevantRebuilds, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RepGraph Streaming Level Dormancy Checks"), STAT_ShooterRepGraphStreamingLevelDormancyChecks, STATGROUP_ShooterGame);
+DECLARE_CYCLE_STAT(TEXT("RepGraph Grid Gather"), STAT_ShooterRepGraphGridGather, STATGROUP_ShooterGame);
+
 float CVar_ShooterRepGraph_DestructionInfoMaxDist = 30000.f;
 static FAutoConsoleVariableRef CVarShooterRepGraphDestructMaxDist(TEXT("ShooterRepGraph.DestructInfo.MaxDist"), CVar_ShooterRepGraph_DestructionInfoMaxDist, TEXT("Max distance (not squared) to rep destruct infos at"), ECVF_Default );
 
@@ -118,12 +134,96 @@ float CVar_ShooterRepGraph_SpatialBiasY = -200000.f;
 static FAutoConsoleVariableRef CVarShooterRepSpatialBiasY(TEXT("ShooterRepGraph.SpatialBiasY"), CVar_ShooterRepGraph_SpatialBiasY, TEXT(""), ECVF_Default );
 
 // How many buckets to spread dynamic, spatialized actors across. High number = more buckets = smaller effective replication frequency. This happens before individual actors do their own NetUpdateFrequency check.
+// With ShooterRepGraph.Adaptive this is only the starting value.
 int32 CVar_ShooterRepGraph_DynamicActorFrequencyBuckets = 3;
 static FAutoConsoleVariableRef CVarShooterRepDynamicActorFrequencyBuckets(TEXT("ShooterRepGraph.DynamicActorFrequencyBuckets"), CVar_ShooterRepGraph_DynamicActorFrequencyBuckets, TEXT(""), ECVF_Default );
 
+// 1: the graph measures its own ServerReplicateActors time and trades dynamic actor buckets and replication periods against Adaptive.TargetMs.
+int32 CVar_ShooterRepGraph_Adaptive = 1;
+static FAutoConsoleVariableRef CVarShooterRepAdaptive(TEXT("ShooterRepGraph.Adaptive"), CVar_ShooterRepGraph_Adaptive, TEXT("0: Fixed buckets and periods, 1: Adjust them to hold Adaptive.TargetMs"), ECVF_Default );
+
+float CVar_ShooterRepGraph_AdaptiveTargetMs = 5.f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptiveTargetMs(TEXT("ShooterRepGraph.Adaptive.TargetMs"), CVar_ShooterRepGraph_AdaptiveTargetMs, TEXT("Time per server frame the replication graph may spend gathering and serializing"), ECVF_Default );
+
+float CVar_ShooterRepGraph_AdaptiveHysteresis = 0.25f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptiveHysteresis(TEXT("ShooterRepGraph.Adaptive.Hysteresis"), CVar_ShooterRepGraph_AdaptiveHysteresis, TEXT("Replication is only relaxed when over TargetMs * (1 + Hysteresis), and only tightened again under TargetMs * (1 - Hysteresis)"), ECVF_Default );
+
+float CVar_ShooterRepGraph_AdaptiveInterval = 1.f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptiveInterval(TEXT("ShooterRepGraph.Adaptive.Interval"), CVar_ShooterRepGraph_AdaptiveInterval, TEXT("Seconds between adjustments"), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_AdaptiveMinBuckets = 1;
+static FAutoConsoleVariableRef CVarShooterRepAdaptiveMinBuckets(TEXT("ShooterRepGraph.Adaptive.MinBuckets"), CVar_ShooterRepGraph_AdaptiveMinBuckets, TEXT(""), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_AdaptiveMaxBuckets = 6;
+static FAutoConsoleVariableRef CVarShooterRepAdaptiveMaxBuckets(TEXT("ShooterRepGraph.Adaptive.MaxBuckets"), CVar_ShooterRepGraph_AdaptiveMaxBuckets, TEXT(""), ECVF_Default );
+
+float CVar_ShooterRepGraph_AdaptiveMaxPeriodScale = 3.f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptiveMaxPeriodScale(TEXT("ShooterRepGraph.Adaptive.MaxPeriodScale"), CVar_ShooterRepGraph_AdaptiveMaxPeriodScale, TEXT("Largest scale applied to class replication periods once the buckets are at MaxBuckets"), ECVF_Default );
+
+float CVar_ShooterRepGraph_AdaptivePeriodScaleStep = 0.5f;
+static FAutoConsoleVariableRef CVarShooterRepAdaptivePeriodScaleStep(TEXT("ShooterRepGraph.Adaptive.PeriodScaleStep"), CVar_ShooterRepGraph_AdaptivePeriodScaleStep, TEXT(""), ECVF_Default );
+
 int32 CVar_ShooterRepGraph_DisableSpatialRebuilds = 1;
 static FAutoConsoleVariableRef CVarShooterRepDisableSpatialRebuilds(TEXT("ShooterRepGraph.DisableSpatialRebuilds"), CVar_ShooterRepGraph_DisableSpatialRebuilds, TEXT(""), ECVF_Default );
 
+// 1: CellSize and SpatialBias are derived from the level bounds and the typical cull distance when a world is initialized. The CellSize/SpatialBias cvars are used as the fallback.
+int32 CVar_ShooterRepGraph_AutoGrid = 1;
+static FAutoConsoleVariableRef CVarShooterRepAutoGrid(TEXT("ShooterRepGraph.AutoGrid"), CVar_ShooterRepGraph_AutoGrid, TEXT("0: Use CellSize/SpatialBias, 1: Size the grid from the level bounds"), ECVF_Default );
+
+// The old fixed 10000 cell with the 15000 pawn cull distance.
+float CVar_ShooterRepGraph_AutoGridCellScale = 0.66f;
+static FAutoConsoleVariableRef CVarShooterRepAutoGridCellScale(TEXT("ShooterRepGraph.AutoGrid.CellScale"), CVar_ShooterRepGraph_AutoGridCellScale, TEXT("Cell size as a fraction of the typical cull distance"), ECVF_Default );
+
+float CVar_ShooterRepGraph_AutoGridMinCellSize = 2000.f;
+static FAutoConsoleVariableRef CVarShooterRepAutoGridMinCellSize(TEXT("ShooterRepGraph.AutoGrid.MinCellSize"), CVar_ShooterRepGraph_AutoGridMinCellSize, TEXT(""), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_AutoGridMaxCellsPerAxis = 64;
+static FAutoConsoleVariableRef CVarShooterRepAutoGridMaxCellsPerAxis(TEXT("ShooterRepGraph.AutoGrid.MaxCellsPerAxis"), CVar_ShooterRepGraph_AutoGridMaxCellsPerAxis, TEXT("Cells grow beyond CellScale when the level would need more than this many on either axis"), ECVF_Default );
+
+// 0: simulated player states are handed out in shared round robin buckets. 1: each connection gets the player states most relevant to it, within PlayerStateBudgetBytes.
+int32 CVar_ShooterRepGraph_PlayerStatePrioritization = 0;
+static FAutoConsoleVariableRef CVarShooterRepPlayerStatePrioritization(TEXT("ShooterRepGraph.PlayerStatePrioritization"), CVar_ShooterRepGraph_PlayerStatePrioritization, TEXT("0: Round robin buckets, 1: Per connection prioritization"), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_PlayerStateBudgetBytes = 128;
+static FAutoConsoleVariableRef CVarShooterRepPlayerStateBudgetBytes(TEXT("ShooterRepGraph.PlayerStateBudgetBytes"), CVar_ShooterRepGraph_PlayerStateBudgetBytes, TEXT("Bytes per connection per frame that prioritized player states may use"), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_PlayerStateEstimatedBytes = 64;
+static FAutoConsoleVariableRef CVarShooterRepPlayerStateEstimatedBytes(TEXT("ShooterRepGraph.PlayerStateEstimatedBytes"), CVar_ShooterRepGraph_PlayerStateEstimatedBytes, TEXT("Estimated serialized size of a player state update, used against PlayerStateBudgetBytes"), ECVF_Default );
+
+float CVar_ShooterRepGraph_PlayerStateTeammateBonus = 30.f;
+static FAutoConsoleVariableRef CVarShooterRepPlayerStateTeammateBonus(TEXT("ShooterRepGraph.PlayerStateTeammateBonus"), CVar_ShooterRepGraph_PlayerStateTeammateBonus, TEXT("Priority bonus (in starved frames) for teammates of the viewer"), ECVF_Default );
+
+float CVar_ShooterRepGraph_PlayerStateRecentFightBonus = 60.f;
+static FAutoConsoleVariableRef CVarShooterRepPlayerStateRecentFightBonus(TEXT("ShooterRepGraph.PlayerStateRecentFightBonus"), CVar_ShooterRepGraph_PlayerStateRecentFightBonus, TEXT("Priority bonus (in starved frames) for players that recently killed or were killed by the viewer"), ECVF_Default );
+
+float CVar_ShooterRepGraph_PlayerStateRecentFightTime = 10.f;
+static FAutoConsoleVariableRef CVarShooterRepPlayerStateRecentFightTime(TEXT("ShooterRepGraph.PlayerStateRecentFightTime"), CVar_ShooterRepGraph_PlayerStateRecentFightTime, TEXT("Seconds a kill or death counts as recent for PlayerStateRecentFightBonus"), ECVF_Default );
+
+float CVar_ShooterRepGraph_PlayerStateNearbyBonus = 30.f;
+static FAutoConsoleVariableRef CVarShooterRepPlayerStateNearbyBonus(TEXT("ShooterRepGraph.PlayerStateNearbyBonus"), CVar_ShooterRepGraph_PlayerStateNearbyBonus, TEXT("Priority bonus (in starved frames) for players whose pawn is right next to the viewer. Falls off linearly to PlayerStateNearbyDistance"), ECVF_Default );
+
+float CVar_ShooterRepGraph_PlayerStateNearbyDistance = 5000.f;
+static FAutoConsoleVariableRef CVarShooterRepPlayerStateNearbyDistance(TEXT("ShooterRepGraph.PlayerStateNearbyDistance"), CVar_ShooterRepGraph_PlayerStateNearbyDistance, TEXT(""), ECVF_Default );
+
+float CVar_ShooterRepGraph_PlayerStateSpectatorScale = 0.25f;
+static FAutoConsoleVariableRef CVarShooterRepPlayerStateSpectatorScale(TEXT("ShooterRepGraph.PlayerStateSpectatorScale"), CVar_ShooterRepGraph_PlayerStateSpectatorScale, TEXT("Priority scale applied to spectator player states"), ECVF_Default );
+
+// Frames between teammate pawn updates returned by UShooterReplicationGraphNode_TeamPawns. Staggered across connections. 0 disables the teammate list.
+int32 CVar_ShooterRepGraph_TeammatePawnPeriod = 10;
+static FAutoConsoleVariableRef CVarShooterRepTeammatePawnPeriod(TEXT("ShooterRepGraph.Team.TeammatePawnPeriod"), CVar_ShooterRepGraph_TeammatePawnPeriod, TEXT("Frames between guaranteed teammate pawn updates at any distance. 0: off"), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_EnemyPawnScaling = 1;
+static FAutoConsoleVariableRef CVarShooterRepEnemyPawnScaling(TEXT("ShooterRepGraph.Team.EnemyPawnScaling"), CVar_ShooterRepGraph_EnemyPawnScaling, TEXT("0: Enemy pawns use their class replication period, 1: Scale it with distance"), ECVF_Default );
+
+float CVar_ShooterRepGraph_EnemyPawnFullRateDistance = 3000.f;
+static FAutoConsoleVariableRef CVarShooterRepEnemyPawnFullRateDistance(TEXT("ShooterRepGraph.Team.EnemyPawnFullRateDistance"), CVar_ShooterRepGraph_EnemyPawnFullRateDistance, TEXT("Enemy pawns closer than this replicate at their class rate"), ECVF_Default );
+
+float CVar_ShooterRepGraph_EnemyPawnMaxPeriodScale = 4.f;
+static FAutoConsoleVariableRef CVarShooterRepEnemyPawnMaxPeriodScale(TEXT("ShooterRepGraph.Team.EnemyPawnMaxPeriodScale"), CVar_ShooterRepGraph_EnemyPawnMaxPeriodScale, TEXT("Replication period scale of enemy pawns at the cull distance. Scales linearly from EnemyPawnFullRateDistance"), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_EnemyPawnUpdateInterval = 4;
+static FAutoConsoleVariableRef CVarShooterRepEnemyPawnUpdateInterval(TEXT("ShooterRepGraph.Team.EnemyPawnUpdateInterval"), CVar_ShooterRepGraph_EnemyPawnUpdateInterval, TEXT("Frames between enemy pawn period updates for a connection"), ECVF_Default );
+
 // ----------------------------------------------------------------------------------------------------------
 
 
@@ -157,27 +257,219 @@ void UShooterReplicationGraph::ResetGameWorldState()
 
 	AlwaysRelevantStreamingLevelActors.Empty();
 
-	for (UNetReplicationGraphConnection* ConnManager : Connections)
+	ForEachAlwaysRelevantConnectionNode([](UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode)
+	{
+		AlwaysRelevantConnectionNode->ResetGameWorldState();
+	});
+}
+
+void UShooterReplicationGraph::InitializeActorsInWorld(UWorld* InWorld)
+{
+	if (InWorld && GridNode)
+	{
+		if (CVar_ShooterRepGraph_AutoGrid > 0)
+		{
+			ConfigureGridFromWorld(InWorld);
+		}
+		else
+		{
+			GridLevelBounds.Init();
+			GridNode->CellSize = CVar_ShooterRepGraph_CellSize;
+			GridNode->SpatialBias = FVector2D(CVar_ShooterRepGraph_SpatialBiasX, CVar_ShooterRepGraph_SpatialBiasY);
+		}
+	}
+
+	Super::InitializeActorsInWorld(InWorld);
+}
+
+int32 UShooterReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	const uint32 StartCycles = FPlatformTime::Cycles();
+
+	const int32 Result = Super::ServerReplicateActors(DeltaSeconds);
+
+	if (CVar_ShooterRepGraph_Adaptive > 0)
+	{
+		UpdateAdaptiveReplication(FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - StartCycles), DeltaSeconds);
+	}
+
+	return Result;
+}
+
+void UShooterReplicationGraph::UpdateAdaptiveReplication(float ReplicateMs, float DeltaSeconds)
+{
+	AdaptiveAverageMs = (AdaptiveAverageMs > 0.f) ? FMath::Lerp(AdaptiveAverageMs, ReplicateMs, 0.1f) : ReplicateMs;
+
+	AdaptiveTimeSinceAdjust += DeltaSeconds;
+	if (AdaptiveTimeSinceAdjust < CVar_ShooterRepGraph_AdaptiveInterval)
+	{
+		return;
+	}
+	AdaptiveTimeSinceAdjust = 0.f;
+
+	const int32 MinBuckets = FMath::Max(1, CVar_ShooterRepGraph_AdaptiveMinBuckets);
+	const int32 MaxBuckets = FMath::Max(MinBuckets, CVar_ShooterRepGraph_AdaptiveMaxBuckets);
+	const float MaxPeriodScale = FMath::Max(1.f, CVar_ShooterRepGraph_AdaptiveMaxPeriodScale);
+	const float PeriodScaleStep = FMath::Max(0.1f, CVar_ShooterRepGraph_AdaptivePeriodScaleStep);
+
+	int32 NewNumBuckets = FMath::Clamp(AdaptiveNumBuckets, MinBuckets, MaxBuckets);
+	float NewPeriodScale = FMath::Clamp(AdaptivePeriodScale, 1.f, MaxPeriodScale);
+
+	// Buckets are the cheaper knob, so they are raised first and lowered last
+	if (AdaptiveAverageMs > CVar_ShooterRepGraph_AdaptiveTargetMs * (1.f + CVar_ShooterRepGraph_AdaptiveHysteresis))
+	{
+		if (NewNumBuckets < MaxBuckets)
+		{
+			NewNumBuckets++;
+		}
+		else
+		{
+			NewPeriodScale = FMath::Min(NewPeriodScale + PeriodScaleStep, MaxPeriodScale);
+		}
+	}
+	else if (AdaptiveAverageMs < CVar_ShooterRepGraph_AdaptiveTargetMs * (1.f - CVar_ShooterRepGraph_AdaptiveHysteresis))
+	{
+		if (NewPeriodScale > 1.f)
+		{
+			NewPeriodScale = FMath::Max(NewPeriodScale - PeriodScaleStep, 1.f);
+		}
+		else if (NewNumBuckets > MinBuckets)
+		{
+			NewNumBuckets--;
+		}
+	}
+
+	if (NewNumBuckets == AdaptiveNumBuckets && NewPeriodScale == AdaptivePeriodScale)
+	{
+		return;
+	}
+
+	UE_LOG(LogShooterReplicationGraph, Display, TEXT("Adaptive replication: %.2f ms avg against %.2f ms target. Dynamic actor buckets %d -> %d, period scale %.2f -> %.2f"),
+		AdaptiveAverageMs, CVar_ShooterRepGraph_AdaptiveTargetMs, AdaptiveNumBuckets, NewNumBuckets, AdaptivePeriodScale, NewPeriodScale);
+
+	if (NewNumBuckets != AdaptiveNumBuckets)
+	{
+		ApplyDynamicActorFrequencyBuckets(NewNumBuckets);
+	}
+
+	if (NewPeriodScale != AdaptivePeriodScale)
+	{
+		ApplyAdaptivePeriodScale(NewPeriodScale);
+	}
+}
+
+void UShooterReplicationGraph::ApplyDynamicActorFrequencyBuckets(int32 NumBuckets)
+{
+	AdaptiveNumBuckets = NumBuckets;
+	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.NumBuckets = NumBuckets;
+
+	// The bucket nodes live inside the grid cells
+	if (GridNode)
+	{
+		for (UReplicationGraphNode* CellNode : GridNode->GetChildNodes())
+		{
+			for (UReplicationGraphNode* CellChildNode : CellNode->GetChildNodes())
+			{
+				if (UReplicationGraphNode_ActorListFrequencyBuckets* BucketNode = Cast<UReplicationGraphNode_ActorListFrequencyBuckets>(CellChildNode))
+				{
+					BucketNode->SetNonStreamingCollectionSize(NumBuckets);
+				}
+			}
+		}
+	}
+}
+
+void UShooterReplicationGraph::ApplyAdaptivePeriodScale(float PeriodScale)
+{
+	AdaptivePeriodScale = PeriodScale;
+
+	auto ScalePeriod = [PeriodScale](uint32 BasePeriod) { return FMath::Max<uint32>((uint32)FMath::RoundToInt(BasePeriod * PeriodScale), 1); };
+
+	// New actors copy their class settings
+	for (const TPair<UClass*, uint32>& ClassPeriod : AdaptiveClassBasePeriods)
+	{
+		GlobalActorReplicationInfoMap.GetClassInfo(ClassPeriod.Key).ReplicationPeriodFrame = ScalePeriod(ClassPeriod.Value);
+	}
+
+	// Existing actors copied them into their global and per connection infos
+	for (auto It = GlobalActorReplicationInfoMap.CreateActorMapIterator(); It; ++It)
 	{
-		for (UReplicationGraphNode* ConnectionNode : ConnManager->GetConnectionGraphNodes())
+		FActorRepListType Actor = It.Key();
+		const uint32* BasePeriod = AdaptiveClassBasePeriods.Find(Actor->GetClass());
+		if (BasePeriod == nullptr)
 		{
-			if (UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = Cast<UShooterReplicationGraphNode_AlwaysRelevant_ForConnection>(ConnectionNode))
+			continue;
+		}
+
+		const uint32 Period = ScalePeriod(*BasePeriod);
+		It.Value()->Settings.ReplicationPeriodFrame = Period;
+
+		for (UNetReplicationGraphConnection* ConnManager : Connections)
+		{
+			if (FConnectionReplicationActorInfo* ConnectionActorInfo = ConnManager->ActorInfoMap.Find(Actor))
 			{
-				AlwaysRelevantConnectionNode->ResetGameWorldState();
+				ConnectionActorInfo->ReplicationPeriodFrame = Period;
 			}
 		}
 	}
+}
+
+void UShooterReplicationGraph::ConfigureGridFromWorld(UWorld* World)
+{
+	// Only levels loaded at init count, streaming levels that are far outside are caught by the grid's own out of bounds handling
+	FBox LevelBounds(ForceInit);
+	for (ULevel* Level : World->GetLevels())
+	{
+		if (Level)
+		{
+			LevelBounds += Level->LevelBoundsActor.IsValid() ? Level->LevelBoundsActor->GetComponentsBoundingBox(true) : ALevelBounds::CalculateLevelBounds(Level);
+		}
+	}
 
-	for (UNetReplicationGraphConnection* ConnManager : PendingConnections)
+	TArray<float> CullDistances;
+	for (AActor* Actor : TActorRange<AActor>(World))
 	{
-		for (UReplicationGraphNode* ConnectionNode : ConnManager->GetConnectionGraphNodes())
+		if (Actor->GetIsReplicated() && IsSpatialized(GetMappingPolicy(Actor->GetClass())))
 		{
-			if (UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = Cast<UShooterReplicationGraphNode_AlwaysRelevant_ForConnection>(ConnectionNode))
+			const float CullDistance = GlobalActorReplicationInfoMap.GetClassInfo(Actor->GetClass()).GetCullDistance();
+			if (CullDistance > 0.f)
 			{
-				AlwaysRelevantConnectionNode->ResetGameWorldState();
+				CullDistances.Add(CullDistance);
 			}
 		}
 	}
+
+	// Pawns are spawned later, but are what the grid mostly moves around
+	if (CullDistances.Num() == 0)
+	{
+		CullDistances.Add(GlobalActorReplicationInfoMap.GetClassInfo(APawn::StaticClass()).GetCullDistance());
+	}
+
+	CullDistances.Sort();
+	const float TypicalCullDistance = CullDistances[CullDistances.Num() / 2];
+
+	if (LevelBounds.IsValid == false || TypicalCullDistance <= 0.f)
+	{
+		UE_LOG(LogShooterReplicationGraph, Warning, TEXT("Could not size the grid for %s, using CellSize %.0f and SpatialBias %.0f/%.0f"), *World->GetMapName(), CVar_ShooterRepGraph_CellSize, CVar_ShooterRepGraph_SpatialBiasX, CVar_ShooterRepGraph_SpatialBiasY);
+		GridLevelBounds.Init();
+		GridNode->CellSize = CVar_ShooterRepGraph_CellSize;
+		GridNode->SpatialBias = FVector2D(CVar_ShooterRepGraph_SpatialBiasX, CVar_ShooterRepGraph_SpatialBiasY);
+		return;
+	}
+
+	// Actors are added to every cell within their cull distance, so leave that much room around the level
+	const FVector2D GridMin = FVector2D(LevelBounds.Min) - FVector2D(TypicalCullDistance, TypicalCullDistance);
+	const FVector2D GridSize = FVector2D(LevelBounds.GetSize()) + FVector2D(TypicalCullDistance, TypicalCullDistance) * 2.f;
+	const float MinCellSizeForAxisLimit = GridSize.GetMax() / FMath::Max(1, CVar_ShooterRepGraph_AutoGridMaxCellsPerAxis);
+
+	GridLevelBounds = LevelBounds;
+	GridTypicalCullDistance = TypicalCullDistance;
+	GridNode->CellSize = FMath::Max3(TypicalCullDistance * CVar_ShooterRepGraph_AutoGridCellScale, CVar_ShooterRepGraph_AutoGridMinCellSize, MinCellSizeForAxisLimit);
+	GridNode->SpatialBias = GridMin;
+
+	UE_LOG(LogShooterReplicationGraph, Display, TEXT("Sized grid for %s: level bounds %s, typical cull distance %.0f -> CellSize %.0f, SpatialBias %s (%d x %d cells)"),
+		*World->GetMapName(), *LevelBounds.ToString(), TypicalCullDistance, GridNode->CellSize, *GridNode->SpatialBias.ToString(),
+		FMath::CeilToInt(GridSize.X / GridNode->CellSize), FMath::CeilToInt(GridSize.Y / GridNode->CellSize));
 }
 
 void UShooterReplicationGraph::InitGlobalActorClassSettings()
@@ -192,7 +484,7 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 
 	AddInfo( AShooterWeapon::StaticClass(),							EClassRepNodeMapping::NotRouted);				// Handled via DependantActor replication (Pawn)
 	AddInfo( ALevelScriptActor::StaticClass(),						EClassRepNodeMapping::NotRouted);				// Not needed
-	AddInfo( APlayerState::StaticClass(),							EClassRepNodeMapping::NotRouted);				// Special cased via UShooterReplicationGraphNode_PlayerStateFrequencyLimiter
+	AddInfo( APlayerState::StaticClass(),							EClassRepNodeMapping::PlayerStateFrequencyLimited);	// Special cased via UShooterReplicationGraphNode_PlayerStateFrequencyLimiter
 	AddInfo( AReplicationGraphDebugActor::StaticClass(),			EClassRepNodeMapping::NotRouted);				// Not needed. Replicated special case inside RepGraph
 	AddInfo( AInfo::StaticClass(),									EClassRepNodeMapping::RelevantAllConnections);	// Non spatialized, relevant to all
 	AddInfo( AShooterPickup::StaticClass(),							EClassRepNodeMapping::Spatialize_Static);		// Spatialized and never moves. Routes to GridNode.
@@ -290,6 +582,10 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 	SetClassInfo( APlayerState::StaticClass(), PlayerStateRepInfo );
 	
 	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.ListSize = 12;
+	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.NumBuckets = FMath::Max(1, CVar_ShooterRepGraph_DynamicActorFrequencyBuckets);
+	AdaptiveNumBuckets = UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.NumBuckets;
+	AdaptivePeriodScale = 1.f;
+	AdaptiveClassBasePeriods.Reset();
 
 	// Set FClassReplicationInfo based on legacy settings from all replicated classes
 	for (UClass* ReplicatedClass : AllReplicatedClasses)
@@ -304,6 +600,12 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 		FClassReplicationInfo ClassInfo;
 		InitClassReplicationInfo(ClassInfo, ReplicatedClass, bClassIsSpatialized, NetDriver->NetServerMaxTickRate);
 		GlobalActorReplicationInfoMap.SetClassInfo( ReplicatedClass, ClassInfo );
+
+		// Pawn periods are scaled per connection by UShooterReplicationGraphNode_TeamPawns
+		if (ClassRepNodePolicies.GetChecked(ReplicatedClass) == EClassRepNodeMapping::Spatialize_Dynamic && !ReplicatedClass->IsChildOf(APawn::StaticClass()))
+		{
+			AdaptiveClassBasePeriods.Add(ReplicatedClass, ClassInfo.ReplicationPeriodFrame);
+		}
 	}
 
 
@@ -350,6 +652,7 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 	
 	AShooterCharacter::NotifyEquipWeapon.AddUObject(this, &UShooterReplicationGraph::OnCharacterEquipWeapon);
 	AShooterCharacter::NotifyUnEquipWeapon.AddUObject(this, &UShooterReplicationGraph::OnCharacterUnEquipWeapon);
+	AShooterCharacter::NotifyInventoryChange.AddUObject(this, &UShooterReplicationGraph::OnCharacterInventoryChange);
 
 #if WITH_GAMEPLAY_DEBUGGER
 	AGameplayDebuggerCategoryReplicator::NotifyDebuggerOwnerChange.AddUObject(this, &UShooterReplicationGraph::OnGameplayDebuggerOwnerChange);
@@ -368,7 +671,8 @@ void UShooterReplicationGraph::InitGlobalGraphNodes()
 	//	Spatial Actors
 	// -----------------------------------------------
 
-	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	// With ShooterRepGraph.AutoGrid these are replaced in InitializeActorsInWorld, before any actor is added
+	GridNode = CreateNewNode<UShooterReplicationGraphNode_GridSpatialization2D>();
 	GridNode->CellSize = CVar_ShooterRepGraph_CellSize;
 	GridNode->SpatialBias = FVector2D(CVar_ShooterRepGraph_SpatialBiasX, CVar_ShooterRepGraph_SpatialBiasY);
 
@@ -388,8 +692,14 @@ void UShooterReplicationGraph::InitGlobalGraphNodes()
 	// -----------------------------------------------
 	//	Player State specialization. This will return a rolling subset of the player states to replicate
 	// -----------------------------------------------
-	UShooterReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode = CreateNewNode<UShooterReplicationGraphNode_PlayerStateFrequencyLimiter>();
+	PlayerStateNode = CreateNewNode<UShooterReplicationGraphNode_PlayerStateFrequencyLimiter>();
 	AddGlobalGraphNode(PlayerStateNode);
+
+	// -----------------------------------------------
+	//	Team aware pawn replication, on top of the GridNode
+	// -----------------------------------------------
+	TeamPawnsNode = CreateNewNode<UShooterReplicationGraphNode_TeamPawns>();
+	AddGlobalGraphNode(TeamPawnsNode);
 }
 
 void UShooterReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
@@ -414,6 +724,11 @@ EClassRepNodeMapping UShooterReplicationGraph::GetMappingPolicy(UClass* Class)
 
 void UShooterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
 {
+	if (ActorInfo.Class->IsChildOf(AShooterCharacter::StaticClass()))
+	{
+		TeamPawnsNode->AddPawn(ActorInfo, GlobalInfo);
+	}
+
 	EClassRepNodeMapping Policy = GetMappingPolicy(ActorInfo.Class);
 	switch(Policy)
 	{
@@ -433,10 +748,21 @@ void UShooterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedA
 				FActorRepListRefView& RepList = AlwaysRelevantStreamingLevelActors.FindOrAdd(ActorInfo.StreamingLevelName);
 				RepList.PrepareForWrite();
 				RepList.ConditionalAdd(ActorInfo.Actor);
+
+				// Connections track which of these actors are dormant on them, see UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherStreamingLevelActors
+				GlobalInfo.Events.DormancyChange.AddUObject(this, &UShooterReplicationGraph::OnStreamingLevelActorDormancyChange);
+				GlobalInfo.Events.DormancyFlush.AddUObject(this, &UShooterReplicationGraph::OnStreamingLevelActorDormancyFlush);
+				NotifyStreamingLevelActorAwake(ActorInfo.StreamingLevelName, ActorInfo.Actor);
 			}
 			break;
 		}
 
+		case EClassRepNodeMapping::PlayerStateFrequencyLimited:
+		{
+			PlayerStateNode->NotifyAddNetworkActor(ActorInfo);
+			break;
+		}
+
 		case EClassRepNodeMapping::Spatialize_Static:
 		{
 			GridNode->AddActor_Static(ActorInfo, GlobalInfo);
@@ -459,6 +785,11 @@ void UShooterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedA
 
 void UShooterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
 {
+	if (ActorInfo.Class->IsChildOf(AShooterCharacter::StaticClass()))
+	{
+		TeamPawnsNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+
 	EClassRepNodeMapping Policy = GetMappingPolicy(ActorInfo.Class);
 	switch(Policy)
 	{
@@ -480,10 +811,27 @@ void UShooterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicat
 				{
 					UE_LOG(LogShooterReplicationGraph, Warning, TEXT("Actor %s was not found in AlwaysRelevantStreamingLevelActors list. LevelName: %s"), *GetActorRepListTypeDebugString(ActorInfo.Actor), *ActorInfo.StreamingLevelName.ToString());
 				}				
+
+				if (FGlobalActorReplicationInfo* GlobalInfo = GlobalActorReplicationInfoMap.Find(ActorInfo.Actor))
+				{
+					GlobalInfo->Events.DormancyChange.RemoveAll(this);
+					GlobalInfo->Events.DormancyFlush.RemoveAll(this);
+				}
+
+				ForEachAlwaysRelevantConnectionNode([&ActorInfo](UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode)
+				{
+					AlwaysRelevantConnectionNode->OnStreamingLevelActorRemoved(ActorInfo.StreamingLevelName, ActorInfo.Actor);
+				});
 			}
 			break;
 		}
 
+		case EClassRepNodeMapping::PlayerStateFrequencyLimited:
+		{
+			PlayerStateNode->NotifyRemoveNetworkActor(ActorInfo);
+			break;
+		}
+
 		case EClassRepNodeMapping::Spatialize_Static:
 		{
 			GridNode->RemoveActor_Static(ActorInfo);
@@ -531,38 +879,87 @@ void UShooterReplicationGraph::OnCharacterUnEquipWeapon(AShooterCharacter* Chara
 	}
 }
 
-#if WITH_GAMEPLAY_DEBUGGER
-void UShooterReplicationGraph::OnGameplayDebuggerOwnerChange(AGameplayDebuggerCategoryReplicator* Debugger, APlayerController* OldOwner)
+void UShooterReplicationGraph::OnCharacterInventoryChange(AShooterCharacter* Character)
+{
+	if (Character)
+	{
+		CHECK_WORLDS(Character);
+
+		if (UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = FindAlwaysRelevantConnectionNode(Character->GetNetConnection()))
+		{
+			AlwaysRelevantConnectionNode->MarkActorListDirty();
+		}
+	}
+}
+
+UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* UShooterReplicationGraph::FindAlwaysRelevantConnectionNode(UNetConnection* NetConnection)
 {
-	auto GetAlwaysRelevantForConnectionNode = [&](APlayerController* Controller) -> UShooterReplicationGraphNode_AlwaysRelevant_ForConnection*
+	if (NetConnection)
 	{
-		if (OldOwner)
+		if (UNetReplicationGraphConnection* GraphConnection = FindOrAddConnectionManager(NetConnection))
 		{
-			if (UNetConnection* NetConnection = OldOwner->GetNetConnection())
+			for (UReplicationGraphNode* ConnectionNode : GraphConnection->GetConnectionGraphNodes())
 			{
-				if (UNetReplicationGraphConnection* GraphConnection = FindOrAddConnectionManager(NetConnection))
+				if (UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = Cast<UShooterReplicationGraphNode_AlwaysRelevant_ForConnection>(ConnectionNode))
 				{
-					for (UReplicationGraphNode* ConnectionNode : GraphConnection->GetConnectionGraphNodes())
-					{
-						if (UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = Cast<UShooterReplicationGraphNode_AlwaysRelevant_ForConnection>(ConnectionNode))
-						{
-							return AlwaysRelevantConnectionNode;
-						}
-					}
+					return AlwaysRelevantConnectionNode;
+				}
+			}
+		}
+	}
+
+	return nullptr;
+}
 
+void UShooterReplicationGraph::ForEachAlwaysRelevantConnectionNode(TFunctionRef<void(UShooterReplicationGraphNode_AlwaysRelevant_ForConnection*)> Func)
+{
+	for (const TArray<UNetReplicationGraphConnection*>* ConnectionList : { &Connections, &PendingConnections })
+	{
+		for (UNetReplicationGraphConnection* ConnManager : *ConnectionList)
+		{
+			for (UReplicationGraphNode* ConnectionNode : ConnManager->GetConnectionGraphNodes())
+			{
+				if (UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = Cast<UShooterReplicationGraphNode_AlwaysRelevant_ForConnection>(ConnectionNode))
+				{
+					Func(AlwaysRelevantConnectionNode);
 				}
 			}
 		}
+	}
+}
 
-		return nullptr;
-	};
+void UShooterReplicationGraph::NotifyStreamingLevelActorAwake(FName LevelName, FActorRepListType Actor)
+{
+	ForEachAlwaysRelevantConnectionNode([LevelName, Actor](UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode)
+	{
+		AlwaysRelevantConnectionNode->OnStreamingLevelActorAwake(LevelName, Actor);
+	});
+}
+
+void UShooterReplicationGraph::OnStreamingLevelActorDormancyChange(FActorRepListType Actor, FGlobalActorReplicationInfo& GlobalInfo, ENetDormancy NewValue, ENetDormancy OldValue)
+{
+	// Going dormant only takes effect per connection once the actor has replicated, GatherStreamingLevelActors picks that up
+	if (NewValue <= DORM_Awake)
+	{
+		NotifyStreamingLevelActorAwake(FNewReplicatedActorInfo(Actor).StreamingLevelName, Actor);
+	}
+}
+
+void UShooterReplicationGraph::OnStreamingLevelActorDormancyFlush(FActorRepListType Actor, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	NotifyStreamingLevelActorAwake(FNewReplicatedActorInfo(Actor).StreamingLevelName, Actor);
+}
 
-	if (UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = GetAlwaysRelevantForConnectionNode(OldOwner))
+#if WITH_GAMEPLAY_DEBUGGER
+void UShooterReplicationGraph::OnGameplayDebuggerOwnerChange(AGameplayDebuggerCategoryReplicator* Debugger, APlayerController* OldOwner)
+{
+	if (UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = FindAlwaysRelevantConnectionNode(OldOwner ? OldOwner->GetNetConnection() : nullptr))
 	{
 		AlwaysRelevantConnectionNode->GameplayDebugger = nullptr;
 	}
 
-	if (UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = GetAlwaysRelevantForConnectionNode(Debugger->GetReplicationOwner()))
+	APlayerController* NewOwner = Debugger->GetReplicationOwner();
+	if (UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = FindAlwaysRelevantConnectionNode(NewOwner ? NewOwner->GetNetConnection() : nullptr))
 	{
 		AlwaysRelevantConnectionNode->GameplayDebugger = Debugger;
 	}
@@ -574,19 +971,62 @@ void UShooterReplicationGraph::OnGameplayDebuggerOwnerChange(AGameplayDebuggerCa
 void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::ResetGameWorldState()
 {
 	AlwaysRelevantStreamingLevelsNeedingReplication.Empty();
+	MarkActorListDirty();
 }
 
-void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+bool UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::HaveViewersChanged(const FConnectionGatherActorListParameters& Params) const
 {
-	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_AlwaysRelevant_ForConnection_GatherActorListsForConnection );
+#if WITH_GAMEPLAY_DEBUGGER
+	if (GameplayDebugger != CachedGameplayDebugger)
+	{
+		return true;
+	}
+#endif
 
-	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
+	if (Params.Viewers.Num() != CachedViewers.Num())
+	{
+		return true;
+	}
+
+	for (int32 Idx = 0; Idx < CachedViewers.Num(); ++Idx)
+	{
+		const FNetViewer& CurViewer = Params.Viewers[Idx];
+		const FShooterAlwaysRelevantViewerInfo& Cached = CachedViewers[Idx];
+		const AShooterPlayerController* PC = Cast<AShooterPlayerController>(CurViewer.InViewer);
+
+		// A destroyed actor may still be in the list even if nothing replaced it
+		if (Cached.ViewTarget.IsStale() || Cached.Pawn.IsStale())
+		{
+			return true;
+		}
+
+		if (Cached.Viewer.Get() != CurViewer.InViewer
+			|| Cached.ViewTarget.Get() != CurViewer.ViewTarget
+			|| Cached.Pawn.Get() != (PC ? PC->GetPawn() : nullptr)
+			|| Cached.PlayerState.Get() != (PC ? PC->PlayerState : nullptr))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::RebuildActorList(const FConnectionGatherActorListParameters& Params)
+{
+	INC_DWORD_STAT(STAT_ShooterRepGraphAlwaysRelevantRebuilds);
+
+	bActorListDirty = false;
 
 	ReplicationActorList.Reset();
+	PlayerStateActorList.Reset();
+
+	// Entries are per viewer index, so the last culled actors survive the rebuild
+	CachedViewers.SetNum(Params.Viewers.Num());
 
-	auto ResetActorCullDistance = [&](AActor* ActorToSet, AActor*& LastActor) {
+	auto ResetActorCullDistance = [&](AActor* ActorToSet, TWeakObjectPtr<AActor>& LastActor) {
 
-		if (ActorToSet != LastActor)
+		if (ActorToSet != LastActor.Get())
 		{
 			LastActor = ActorToSet;
 
@@ -596,52 +1036,42 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorLists
 		}
 	};
 
-	for (const FNetViewer& CurViewer : Params.Viewers)
+	for (int32 ViewerIdx = 0; ViewerIdx < Params.Viewers.Num(); ++ViewerIdx)
 	{
+		const FNetViewer& CurViewer = Params.Viewers[ViewerIdx];
+		FShooterAlwaysRelevantViewerInfo& Cached = CachedViewers[ViewerIdx];
+		Cached.Viewer = CurViewer.InViewer;
+		Cached.ViewTarget = CurViewer.ViewTarget;
+		Cached.Pawn = nullptr;
+		Cached.PlayerState = nullptr;
+
 		ReplicationActorList.ConditionalAdd(CurViewer.InViewer);
 		ReplicationActorList.ConditionalAdd(CurViewer.ViewTarget);
 
 		if (AShooterPlayerController* PC = Cast<AShooterPlayerController>(CurViewer.InViewer))
 		{
-			// 50% throttling of PlayerStates.
-			const bool bReplicatePS = (Params.ConnectionManager.ConnectionId % 2) == (Params.ReplicationFrameNum % 2);
-			if (bReplicatePS)
-			{
-				// Always return the player state to the owning player. Simulated proxy player states are handled by UShooterReplicationGraphNode_PlayerStateFrequencyLimiter
-				if (APlayerState* PS = PC->PlayerState)
-				{
-					if (!bInitializedPlayerState)
-					{
-						bInitializedPlayerState = true;
-						FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(PS);
-						ConnectionActorInfo.ReplicationPeriodFrame = 1;
-					}
-
-					ReplicationActorList.ConditionalAdd(PS);
-				}
-			}
+			Cached.Pawn = PC->GetPawn();
+			Cached.PlayerState = PC->PlayerState;
 
-			FAlwaysRelevantActorInfo* LastData = PastRelevantActors.FindByKey<UNetConnection*>(CurViewer.Connection);
-
-			// We've not seen this actor before, go ahead and add them.
-			if (LastData == nullptr)
+			// Always return the player state to the owning player. Simulated proxy player states are handled by UShooterReplicationGraphNode_PlayerStateFrequencyLimiter
+			if (APlayerState* PS = PC->PlayerState)
 			{
-				FAlwaysRelevantActorInfo NewActorInfo;
-				NewActorInfo.Connection = CurViewer.Connection;
-				LastData = &(PastRelevantActors[PastRelevantActors.Add(NewActorInfo)]);
-			}
+				FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(PS);
+				ConnectionActorInfo.ReplicationPeriodFrame = 1;
 
-			check(LastData != nullptr);
+				PlayerStateActorList.ConditionalAdd(PS);
+			}
 
 			if (AShooterCharacter* Pawn = Cast<AShooterCharacter>(PC->GetPawn()))
 			{
-				ResetActorCullDistance(Pawn, LastData->LastViewer);
+				ResetActorCullDistance(Pawn, Cached.LastCulledPawn);
 
 				if (Pawn != CurViewer.ViewTarget)
 				{
 					ReplicationActorList.ConditionalAdd(Pawn);
 				}
 
+				// The equipped weapon is also a dependent actor of the pawn, see UShooterReplicationGraph::OnCharacterEquipWeapon. The owner needs the whole inventory.
 				int32 InventoryCount = Pawn->GetInventoryCount();
 				for (int32 i = 0; i < InventoryCount; ++i)
 				{
@@ -655,86 +1085,154 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorLists
 
 			if (AShooterCharacter* ViewTargetPawn = Cast<AShooterCharacter>(CurViewer.ViewTarget))
 			{
-				ResetActorCullDistance(ViewTargetPawn, LastData->LastViewTarget);
+				ResetActorCullDistance(ViewTargetPawn, Cached.LastCulledViewTarget);
 			}
 		}
 	}
 
-	PastRelevantActors.RemoveAll([&](FAlwaysRelevantActorInfo& RelActorInfo) {
-		return RelActorInfo.Connection == nullptr;
-	});
+#if WITH_GAMEPLAY_DEBUGGER
+	CachedGameplayDebugger = GameplayDebugger;
+	if (GameplayDebugger)
+	{
+		ReplicationActorList.ConditionalAdd(GameplayDebugger);
+	}
+#endif
+}
+
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterRepGraphAlwaysRelevantGather);
+
+	if (bActorListDirty || HaveViewersChanged(Params))
+	{
+		RebuildActorList(Params);
+	}
 
 	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
 
-	// Always relevant streaming level actors.
+	// 50% throttling of PlayerStates.
+	const bool bReplicatePS = (Params.ConnectionManager.ConnectionId % 2) == (Params.ReplicationFrameNum % 2);
+	if (bReplicatePS && PlayerStateActorList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(PlayerStateActorList);
+	}
+
+	GatherStreamingLevelActors(Params);
+}
+
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherStreamingLevelActors(const FConnectionGatherActorListParameters& Params)
+{
 	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
-	
+
+	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
 	TMap<FName, FActorRepListRefView>& AlwaysRelevantStreamingLevelActors = ShooterGraph->AlwaysRelevantStreamingLevelActors;
 
-	for (int32 Idx=AlwaysRelevantStreamingLevelsNeedingReplication.Num()-1; Idx >= 0; --Idx)
+	for (FShooterAlwaysRelevantStreamingLevel& StreamingLevel : AlwaysRelevantStreamingLevelsNeedingReplication)
 	{
-		const FName& StreamingLevel = AlwaysRelevantStreamingLevelsNeedingReplication[Idx];
-
-		FActorRepListRefView* Ptr = AlwaysRelevantStreamingLevelActors.Find(StreamingLevel);
-		if (Ptr == nullptr)
+		// Levels whose actors are all dormant on this connection cost nothing until one of them is woken up or flushed
+		if (StreamingLevel.bNeedsRecount == false && StreamingLevel.AwakeActors.Num() == 0)
 		{
-			// No always relevant lists for that level
-			UE_CLOG(CVar_ShooterRepGraph_DisplayClientLevelStreaming > 0, LogShooterReplicationGraph, Display, TEXT("CLIENTSTREAMING Removing %s from AlwaysRelevantStreamingLevelActors because FActorRepListRefView is null. %s "), *StreamingLevel.ToString(),  *Params.ConnectionManager.GetName());
-			AlwaysRelevantStreamingLevelsNeedingReplication.RemoveAtSwap(Idx, 1, false);
 			continue;
 		}
 
-		FActorRepListRefView& RepList = *Ptr;
+		FActorRepListRefView* Ptr = AlwaysRelevantStreamingLevelActors.Find(StreamingLevel.LevelName);
 
-		if (RepList.Num() > 0)
+		if (StreamingLevel.bNeedsRecount)
 		{
-			bool bAllDormant = true;
-			for (FActorRepListType Actor : RepList)
+			StreamingLevel.bNeedsRecount = false;
+			StreamingLevel.AwakeActors.Reset();
+
+			if (Ptr == nullptr)
 			{
-				FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(Actor);
-				if (ConnectionActorInfo.bDormantOnConnection == false)
-				{
-					bAllDormant = false;
-					break;
-				}
+				// No always relevant lists for that level. Actors added later are passed in through OnStreamingLevelActorAwake.
+				UE_CLOG(CVar_ShooterRepGraph_DisplayClientLevelStreaming > 0, LogShooterReplicationGraph, Display, TEXT("CLIENTSTREAMING No AlwaysRelevantStreamingLevelActors for %s. %s "), *StreamingLevel.LevelName.ToString(),  *Params.ConnectionManager.GetName());
+				continue;
 			}
 
-			if (bAllDormant)
+			for (FActorRepListType Actor : *Ptr)
 			{
-				UE_CLOG(CVar_ShooterRepGraph_DisplayClientLevelStreaming > 0, LogShooterReplicationGraph, Display, TEXT("CLIENTSTREAMING All AlwaysRelevant Actors Dormant on StreamingLevel %s for %s. Removing list."), *StreamingLevel.ToString(), *Params.ConnectionManager.GetName());
-				AlwaysRelevantStreamingLevelsNeedingReplication.RemoveAtSwap(Idx, 1, false);
+				StreamingLevel.AwakeActors.Add(Actor);
 			}
-			else
+		}
+
+		if (Ptr == nullptr)
+		{
+			StreamingLevel.AwakeActors.Reset();
+			continue;
+		}
+
+		// Drop actors that have gone dormant on this connection. An actor that never goes dormant keeps the level awake without touching the connection info.
+		bool bAllDormant = true;
+		for (int32 Idx = StreamingLevel.AwakeActors.Num() - 1; Idx >= 0; --Idx)
+		{
+			FActorRepListType Actor = StreamingLevel.AwakeActors[Idx];
+			if (Actor->NetDormancy <= DORM_Awake)
+			{
+				bAllDormant = false;
+				break;
+			}
+
+			INC_DWORD_STAT(STAT_ShooterRepGraphStreamingLevelDormancyChecks);
+
+			FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(Actor);
+			if (ConnectionActorInfo.bDormantOnConnection == false)
 			{
-				UE_CLOG(CVar_ShooterRepGraph_DisplayClientLevelStreaming > 0, LogShooterReplicationGraph, Display, TEXT("CLIENTSTREAMING Adding always Actors on StreamingLevel %s for %s because it has at least one non dormant actor"), *StreamingLevel.ToString(), *Params.ConnectionManager.GetName());
-				Params.OutGatheredReplicationLists.AddReplicationActorList(RepList);
+				bAllDormant = false;
+				break;
 			}
+
+			StreamingLevel.AwakeActors.RemoveAtSwap(Idx, 1, false);
 		}
-		else
+
+		if (bAllDormant)
+		{
+			UE_CLOG(CVar_ShooterRepGraph_DisplayClientLevelStreaming > 0, LogShooterReplicationGraph, Display, TEXT("CLIENTSTREAMING All AlwaysRelevant Actors Dormant on StreamingLevel %s for %s. Skipping list."), *StreamingLevel.LevelName.ToString(), *Params.ConnectionManager.GetName());
+		}
+		else if (Ptr->Num() > 0)
 		{
-			UE_LOG(LogShooterReplicationGraph, Warning, TEXT("UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection - empty RepList %s"), *Params.ConnectionManager.GetName());
+			Params.OutGatheredReplicationLists.AddReplicationActorList(*Ptr);
 		}
+	}
+}
 
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnStreamingLevelActorAwake(FName LevelName, FActorRepListType Actor)
+{
+	for (FShooterAlwaysRelevantStreamingLevel& StreamingLevel : AlwaysRelevantStreamingLevelsNeedingReplication)
+	{
+		if (StreamingLevel.LevelName == LevelName)
+		{
+			// A pending recount picks the actor up anyway
+			if (StreamingLevel.bNeedsRecount == false)
+			{
+				StreamingLevel.AwakeActors.AddUnique(Actor);
+			}
+			break;
+		}
 	}
+}
 
-#if WITH_GAMEPLAY_DEBUGGER
-	if (GameplayDebugger)
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnStreamingLevelActorRemoved(FName LevelName, FActorRepListType Actor)
+{
+	for (FShooterAlwaysRelevantStreamingLevel& StreamingLevel : AlwaysRelevantStreamingLevelsNeedingReplication)
 	{
-		ReplicationActorList.ConditionalAdd(GameplayDebugger);
+		if (StreamingLevel.LevelName == LevelName)
+		{
+			StreamingLevel.AwakeActors.RemoveSingleSwap(Actor, false);
+			break;
+		}
 	}
-#endif
 }
 
 void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityAdd(FName LevelName, UWorld* StreamingWorld)
 {
 	UE_CLOG(CVar_ShooterRepGraph_DisplayClientLevelStreaming > 0, LogShooterReplicationGraph, Display, TEXT("CLIENTSTREAMING ::OnClientLevelVisibilityAdd - %s"), *LevelName.ToString());
-	AlwaysRelevantStreamingLevelsNeedingReplication.Add(LevelName);
+	AlwaysRelevantStreamingLevelsNeedingReplication.Emplace(LevelName);
 }
 
 void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove(FName LevelName)
 {
 	UE_CLOG(CVar_ShooterRepGraph_DisplayClientLevelStreaming > 0, LogShooterReplicationGraph, Display, TEXT("CLIENTSTREAMING ::OnClientLevelVisibilityRemove - %s"), *LevelName.ToString());
-	AlwaysRelevantStreamingLevelsNeedingReplication.Remove(LevelName);
+	AlwaysRelevantStreamingLevelsNeedingReplication.RemoveAll([LevelName](const FShooterAlwaysRelevantStreamingLevel& StreamingLevel) { return StreamingLevel.LevelName == LevelName; });
 }
 
 void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
@@ -742,13 +1240,14 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::LogNode(FReplica
 	DebugInfo.Log(NodeName);
 	DebugInfo.PushIndent();
 	LogActorRepList(DebugInfo, NodeName, ReplicationActorList);
+	LogActorRepList(DebugInfo, TEXT("PlayerStates"), PlayerStateActorList);
 
-	for (const FName& LevelName : AlwaysRelevantStreamingLevelsNeedingReplication)
+	for (const FShooterAlwaysRelevantStreamingLevel& StreamingLevel : AlwaysRelevantStreamingLevelsNeedingReplication)
 	{
 		UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
-		if (FActorRepListRefView* RepList = ShooterGraph->AlwaysRelevantStreamingLevelActors.Find(LevelName))
+		if (FActorRepListRefView* RepList = ShooterGraph->AlwaysRelevantStreamingLevelActors.Find(StreamingLevel.LevelName))
 		{
-			LogActorRepList(DebugInfo, FString::Printf(TEXT("AlwaysRelevant StreamingLevel List: %s"), *LevelName.ToString()), *RepList);
+			LogActorRepList(DebugInfo, FString::Printf(TEXT("AlwaysRelevant StreamingLevel List: %s (%d awake)"), *StreamingLevel.LevelName.ToString(), StreamingLevel.AwakeActors.Num()), *RepList);
 		}
 	}
 
@@ -760,45 +1259,131 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::LogNode(FReplica
 UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::UShooterReplicationGraphNode_PlayerStateFrequencyLimiter()
 {
 	bRequiresPrepareForReplicationCall = true;
+
+	// Gather always indexes into this array, so keep at least one (possibly empty) bucket around
+	ReplicationActorLists.AddDefaulted();
+	ReplicationActorLists[0].PrepareForWrite();
 }
 
-void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::PrepareForReplication()
+void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
 {
-	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_PlayerStateFrequencyLimiter_GlobalPrepareForReplication );
+	if (PlayerStateIndices.Contains(ActorInfo.Actor))
+	{
+		return;
+	}
 
-	ReplicationActorLists.Reset();
-	ForceNetUpdateReplicationActorList.Reset();
+	const int32 NewIdx = PlayerStates.Add(ActorInfo.Actor);
+	PlayerStateIndices.Add(ActorInfo.Actor, NewIdx);
 
-	ReplicationActorLists.AddDefaulted();
-	FActorRepListRefView* CurrentList = &ReplicationActorLists[0];
-	CurrentList->PrepareForWrite();
+	const int32 BucketIdx = NewIdx / TargetActorsPerFrame;
+	if (BucketIdx >= ReplicationActorLists.Num())
+	{
+		ReplicationActorLists.AddDefaulted();
+		ReplicationActorLists.Last().PrepareForWrite();
+	}
+
+	ReplicationActorLists[BucketIdx].Add(ActorInfo.Actor);
+}
 
-	// We rebuild our lists of player states each frame. This is not as efficient as it could be but its the simplest way
-	// to handle players disconnecting and keeping the lists compact. If the lists were persistent we would need to defrag them as players left.
+bool UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	int32 RemovedIdx = INDEX_NONE;
+	if (PlayerStateIndices.RemoveAndCopyValue(ActorInfo.Actor, RemovedIdx) == false)
+	{
+		UE_CLOG(bWarnIfNotFound, LogShooterReplicationGraph, Warning, TEXT("Attempted to remove %s from PlayerStateFrequencyLimiter but it was not found."), *GetActorRepListTypeDebugString(ActorInfo.Actor));
+		return false;
+	}
 
-	for (TActorIterator<APlayerState> It(GetWorld()); It; ++It)
+	// Swap the last player state into the hole so the buckets stay compact. Only the two buckets involved need rebuilding.
+	const int32 LastIdx = PlayerStates.Num() - 1;
+	if (RemovedIdx != LastIdx)
 	{
-		APlayerState* PS = *It;
-		if (IsActorValidForReplicationGather(PS) == false)
-		{
-			continue;
-		}
+		FActorRepListType MovedActor = PlayerStates[LastIdx];
+		PlayerStates[RemovedIdx] = MovedActor;
+		PlayerStateIndices.FindChecked(MovedActor) = RemovedIdx;
+	}
+	PlayerStates.RemoveAt(LastIdx, 1, false);
+
+	const int32 RemovedBucketIdx = RemovedIdx / TargetActorsPerFrame;
+	const int32 LastBucketIdx = LastIdx / TargetActorsPerFrame;
+
+	if (LastBucketIdx > 0 && LastBucketIdx * TargetActorsPerFrame >= PlayerStates.Num())
+	{
+		// The last bucket is now empty
+		ReplicationActorLists.RemoveAt(LastBucketIdx, 1, false);
+	}
+	else
+	{
+		RebuildBucket(LastBucketIdx);
+	}
+
+	if (RemovedBucketIdx != LastBucketIdx)
+	{
+		RebuildBucket(RemovedBucketIdx);
+	}
+
+	return true;
+}
+
+void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyResetAllNetworkActors()
+{
+	PlayerStates.Reset();
+	PlayerStateIndices.Reset();
+
+	ReplicationActorLists.SetNum(1);
+	ReplicationActorLists[0].Reset();
+	ForceNetUpdateReplicationActorList.Reset();
+}
+
+void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::RebuildBucket(int32 BucketIdx)
+{
+	FActorRepListRefView& Bucket = ReplicationActorLists[BucketIdx];
+	Bucket.Reset();
+	Bucket.PrepareForWrite();
+
+	const int32 EndIdx = FMath::Min((BucketIdx + 1) * TargetActorsPerFrame, PlayerStates.Num());
+	for (int32 Idx = BucketIdx * TargetActorsPerFrame; Idx < EndIdx; ++Idx)
+	{
+		Bucket.Add(PlayerStates[Idx]);
+	}
+}
 
-		if (CurrentList->Num() >= TargetActorsPerFrame)
+void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::PrepareForReplication()
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_PlayerStateFrequencyLimiter_GlobalPrepareForReplication );
+
+	// The buckets are maintained by the add/remove notifications, so there is nothing to rebuild here.
+	ForceNetUpdateReplicationActorList.Reset();
+
+	// Drop lists belonging to connections that have gone away
+	if (PrioritizedConnectionLists.Num() > 0 && (GFrameCounter % 300) == 0)
+	{
+		for (auto It = PrioritizedConnectionLists.CreateIterator(); It; ++It)
 		{
-			ReplicationActorLists.AddDefaulted();
-			CurrentList = &ReplicationActorLists.Last(); 
-			CurrentList->PrepareForWrite();
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
 		}
-		
-		CurrentList->Add(PS);
-	}	
+	}
 }
 
 void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
-	const int32 ListIdx = Params.ReplicationFrameNum % ReplicationActorLists.Num();
-	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorLists[ListIdx]);
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_PlayerStateFrequencyLimiter_GatherActorListsForConnection );
+
+	if (CVar_ShooterRepGraph_PlayerStatePrioritization > 0)
+	{
+		GatherPrioritizedListForConnection(Params);
+	}
+	else
+	{
+		const int32 ListIdx = Params.ReplicationFrameNum % ReplicationActorLists.Num();
+		if (ReplicationActorLists[ListIdx].Num() > 0)
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorLists[ListIdx]);
+		}
+	}
 
 	if (ForceNetUpdateReplicationActorList.Num() > 0)
 	{
@@ -806,6 +1391,92 @@ void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::GatherActorListsF
 	}	
 }
 
+void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::GatherPrioritizedListForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	const int32 MaxActors = FMath::Max(1, CVar_ShooterRepGraph_PlayerStateBudgetBytes / FMath::Max(1, CVar_ShooterRepGraph_PlayerStateEstimatedBytes));
+
+	FActorRepListRefView& ConnectionList = PrioritizedConnectionLists.FindOrAdd(&Params.ConnectionManager);
+	ConnectionList.Reset();
+	ConnectionList.PrepareForWrite();
+
+	if (PlayerStates.Num() == 0 || Params.Viewers.Num() == 0)
+	{
+		return;
+	}
+
+	// The owning player's own state is replicated by UShooterReplicationGraphNode_AlwaysRelevant_ForConnection
+	const FNetViewer& Viewer = Params.Viewers[0];
+	const APlayerController* ViewerPC = Cast<APlayerController>(Viewer.InViewer);
+	const AShooterPlayerState* ViewerPS = ViewerPC ? Cast<AShooterPlayerState>(ViewerPC->PlayerState) : nullptr;
+
+	const AShooterGameState* GameState = GetWorld()->GetGameState<AShooterGameState>();
+	const bool bHasTeams = GameState && GameState->NumTeams > 1;
+	const float NearbyDistSq = FMath::Square(CVar_ShooterRepGraph_PlayerStateNearbyDistance);
+
+	// Priority is measured in frames: a player state that has been starved for N frames scores N, relevance adds on top so relevant players replicate more often
+	// while starvation still guarantees everybody on the scoreboard is refreshed eventually.
+	TArray<TPair<float, FActorRepListType>, TInlineAllocator<128>> ScoredPlayerStates;
+
+	for (FActorRepListType Actor : PlayerStates)
+	{
+		const APlayerState* PlayerState = CastChecked<APlayerState>(Actor);
+		const AShooterPlayerState* PS = Cast<AShooterPlayerState>(PlayerState);
+		if ((ViewerPC && PlayerState == ViewerPC->PlayerState) || IsActorValidForReplicationGather(Actor) == false)
+		{
+			continue;
+		}
+
+		const FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(Actor);
+		float Priority = (float)(Params.ReplicationFrameNum - ConnectionActorInfo.LastRepFrameNum);
+
+		if (PS && ViewerPS)
+		{
+			if (bHasTeams && PS->GetTeamNum() == ViewerPS->GetTeamNum())
+			{
+				Priority += CVar_ShooterRepGraph_PlayerStateTeammateBonus;
+			}
+
+			if (ViewerPS->HasRecentlyFought(PS, CVar_ShooterRepGraph_PlayerStateRecentFightTime))
+			{
+				Priority += CVar_ShooterRepGraph_PlayerStateRecentFightBonus;
+			}
+		}
+
+		const AController* OwnerController = Cast<AController>(PlayerState->GetOwner());
+		if (const APawn* Pawn = OwnerController ? OwnerController->GetPawn() : nullptr)
+		{
+			const float DistSq = FVector::DistSquared(Pawn->GetActorLocation(), Viewer.ViewLocation);
+			if (DistSq < NearbyDistSq)
+			{
+				Priority += CVar_ShooterRepGraph_PlayerStateNearbyBonus * (1.f - FMath::Sqrt(DistSq / NearbyDistSq));
+			}
+		}
+
+		if (PlayerState->bIsSpectator)
+		{
+			Priority *= CVar_ShooterRepGraph_PlayerStateSpectatorScale;
+		}
+
+		ScoredPlayerStates.Emplace(Priority, Actor);
+	}
+
+	if (ScoredPlayerStates.Num() > MaxActors)
+	{
+		ScoredPlayerStates.Sort([](const TPair<float, FActorRepListType>& A, const TPair<float, FActorRepListType>& B) { return A.Key > B.Key; });
+		ScoredPlayerStates.SetNum(MaxActors, false);
+	}
+
+	for (const TPair<float, FActorRepListType>& Scored : ScoredPlayerStates)
+	{
+		ConnectionList.Add(Scored.Value);
+	}
+
+	if (ConnectionList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(ConnectionList);
+	}
+}
+
 void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
 {
 	DebugInfo.Log(NodeName);
@@ -822,6 +1493,342 @@ void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::LogNode(FReplicat
 
 // ------------------------------------------------------------------------------
 
+UShooterReplicationGraphNode_TeamPawns::UShooterReplicationGraphNode_TeamPawns()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UShooterReplicationGraphNode_TeamPawns::AddPawn(const FNewReplicatedActorInfo& ActorInfo, const FGlobalActorReplicationInfo& GlobalInfo)
+{
+	if (PawnIndices.Contains(ActorInfo.Actor))
+	{
+		return;
+	}
+
+	FShooterTeamPawnInfo& PawnInfo = Pawns.AddDefaulted_GetRef();
+	PawnInfo.Actor = ActorInfo.Actor;
+	PawnInfo.BaseReplicationPeriodFrame = FMath::Max<uint32>(GlobalInfo.Settings.ReplicationPeriodFrame, 1);
+	PawnInfo.CullDistanceSquared = GlobalInfo.Settings.GetCullDistanceSquared();
+	PawnInfo.ActorChannelFrameTimeout = GlobalInfo.Settings.ActorChannelFrameTimeout;
+
+	PawnIndices.Add(ActorInfo.Actor, Pawns.Num() - 1);
+
+	// Its team is picked up in PrepareForReplication
+}
+
+bool UShooterReplicationGraphNode_TeamPawns::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	int32 RemovedIdx = INDEX_NONE;
+	if (PawnIndices.RemoveAndCopyValue(ActorInfo.Actor, RemovedIdx) == false)
+	{
+		UE_CLOG(bWarnIfNotFound, LogShooterReplicationGraph, Warning, TEXT("Attempted to remove %s from TeamPawns but it was not found."), *GetActorRepListTypeDebugString(ActorInfo.Actor));
+		return false;
+	}
+
+	Pawns.RemoveAtSwap(RemovedIdx, 1, false);
+	if (RemovedIdx < Pawns.Num())
+	{
+		PawnIndices.FindChecked(Pawns[RemovedIdx].Actor) = RemovedIdx;
+	}
+
+	bTeamListsDirty = true;
+	return true;
+}
+
+void UShooterReplicationGraphNode_TeamPawns::NotifyResetAllNetworkActors()
+{
+	Pawns.Reset();
+	PawnIndices.Reset();
+	TeamPawnLists.Reset();
+	bTeamListsDirty = true;
+}
+
+void UShooterReplicationGraphNode_TeamPawns::PrepareForReplication()
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_TeamPawns_PrepareForReplication );
+
+	const AShooterGameState* GameState = GetWorld()->GetGameState<AShooterGameState>();
+	bHasTeams = GameState && GameState->NumTeams > 1;
+
+	// Teams change rarely, so the shared lists are only rebuilt when one of them did
+	for (FShooterTeamPawnInfo& PawnInfo : Pawns)
+	{
+		const AShooterCharacter* Character = CastChecked<AShooterCharacter>(PawnInfo.Actor);
+		const AShooterPlayerState* PlayerState = Character->GetPlayerState<AShooterPlayerState>();
+		const int32 TeamNum = PlayerState ? PlayerState->GetTeamNum() : INDEX_NONE;
+
+		PawnInfo.PlayerState = PlayerState;
+		if (PawnInfo.TeamNum != TeamNum)
+		{
+			PawnInfo.TeamNum = TeamNum;
+			bTeamListsDirty = true;
+		}
+	}
+
+	if (bTeamListsDirty)
+	{
+		bTeamListsDirty = false;
+		TeamListVersion++;
+
+		for (auto& TeamList : TeamPawnLists)
+		{
+			TeamList.Value.Reset();
+		}
+
+		for (const FShooterTeamPawnInfo& PawnInfo : Pawns)
+		{
+			if (PawnInfo.TeamNum != INDEX_NONE)
+			{
+				FActorRepListRefView& TeamList = TeamPawnLists.FindOrAdd(PawnInfo.TeamNum);
+				TeamList.PrepareForWrite();
+				TeamList.Add(PawnInfo.Actor);
+			}
+		}
+	}
+
+	// Drop infos belonging to connections that have gone away
+	if (ConnectionInfos.Num() > 0 && (GFrameCounter % 300) == 0)
+	{
+		for (auto It = ConnectionInfos.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
+
+void UShooterReplicationGraphNode_TeamPawns::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_TeamPawns_GatherActorListsForConnection );
+
+	if (Params.Viewers.Num() == 0)
+	{
+		return;
+	}
+
+	const APlayerController* ViewerPC = Cast<APlayerController>(Params.Viewers[0].InViewer);
+	const AShooterPlayerState* ViewerPS = ViewerPC ? Cast<AShooterPlayerState>(ViewerPC->PlayerState) : nullptr;
+	const int32 TeamNum = (bHasTeams && ViewerPS && CVar_ShooterRepGraph_TeammatePawnPeriod > 0) ? ViewerPS->GetTeamNum() : INDEX_NONE;
+	const uint32 ConnectionId = (uint32)Params.ConnectionManager.ConnectionId;
+
+	FShooterTeamConnectionInfo& ConnectionInfo = ConnectionInfos.FindOrAdd(&Params.ConnectionManager);
+	if (ConnectionInfo.TeamNum != TeamNum || ConnectionInfo.TeamListVersion != TeamListVersion)
+	{
+		UpdateTeammatesForConnection(Params, ConnectionInfo, TeamNum, ViewerPS);
+	}
+
+	// Teammates at any range, at a low frequency. The GridNode still returns nearby ones every frame.
+	if (TeamNum != INDEX_NONE && ((Params.ReplicationFrameNum + ConnectionId) % (uint32)CVar_ShooterRepGraph_TeammatePawnPeriod) == 0)
+	{
+		const FActorRepListRefView* TeamList = TeamPawnLists.Find(TeamNum);
+		if (TeamList && TeamList->Num() > 0)
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(*TeamList);
+		}
+	}
+
+	const uint32 EnemyUpdateInterval = (uint32)FMath::Max(1, CVar_ShooterRepGraph_EnemyPawnUpdateInterval);
+	if (CVar_ShooterRepGraph_EnemyPawnScaling > 0 && ((Params.ReplicationFrameNum + ConnectionId) % EnemyUpdateInterval) == 0)
+	{
+		UpdateEnemyFrequenciesForConnection(Params, TeamNum, ViewerPS);
+	}
+}
+
+void UShooterReplicationGraphNode_TeamPawns::UpdateTeammatesForConnection(const FConnectionGatherActorListParameters& Params, FShooterTeamConnectionInfo& ConnectionInfo, int32 TeamNum, const APlayerState* ViewerPS)
+{
+	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
+
+	// Former teammates that are still around get their class cull distance and channel timeout back
+	for (FActorRepListType Actor : ConnectionInfo.Teammates)
+	{
+		if (const int32* PawnIdx = PawnIndices.Find(Actor))
+		{
+			const FShooterTeamPawnInfo& PawnInfo = Pawns[*PawnIdx];
+			if (PawnInfo.TeamNum != TeamNum || TeamNum == INDEX_NONE)
+			{
+				FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(Actor);
+				ConnectionActorInfo.SetCullDistanceSquared(PawnInfo.CullDistanceSquared);
+				ConnectionActorInfo.ActorChannelFrameTimeout = PawnInfo.ActorChannelFrameTimeout;
+			}
+		}
+	}
+
+	ConnectionInfo.TeamNum = TeamNum;
+	ConnectionInfo.TeamListVersion = TeamListVersion;
+	ConnectionInfo.Teammates.Reset();
+
+	if (TeamNum == INDEX_NONE)
+	{
+		return;
+	}
+
+	for (const FShooterTeamPawnInfo& PawnInfo : Pawns)
+	{
+		// The viewer's own pawn is handled by UShooterReplicationGraphNode_AlwaysRelevant_ForConnection
+		if (PawnInfo.TeamNum != TeamNum || PawnInfo.PlayerState == ViewerPS)
+		{
+			continue;
+		}
+
+		FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(PawnInfo.Actor);
+		ConnectionActorInfo.SetCullDistanceSquared(0.f);
+		ConnectionActorInfo.ReplicationPeriodFrame = PawnInfo.BaseReplicationPeriodFrame;
+
+		// Far teammates are only gathered every TeammatePawnPeriod frames, their channel has to stay open in between
+		ConnectionActorInfo.ActorChannelFrameTimeout = (uint8)FMath::Min<int32>(PawnInfo.ActorChannelFrameTimeout + CVar_ShooterRepGraph_TeammatePawnPeriod, MAX_uint8);
+
+		ConnectionInfo.Teammates.Add(PawnInfo.Actor);
+	}
+}
+
+void UShooterReplicationGraphNode_TeamPawns::UpdateEnemyFrequenciesForConnection(const FConnectionGatherActorListParameters& Params, int32 TeamNum, const APlayerState* ViewerPS)
+{
+	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
+	const FVector& ViewLocation = Params.Viewers[0].ViewLocation;
+	const float FullRateDistance = CVar_ShooterRepGraph_EnemyPawnFullRateDistance;
+	const float MaxPeriodScale = FMath::Max(1.f, CVar_ShooterRepGraph_EnemyPawnMaxPeriodScale);
+	const float AdaptivePeriodScale = CastChecked<UShooterReplicationGraph>(GetOuter())->GetAdaptivePeriodScale();
+
+	for (const FShooterTeamPawnInfo& PawnInfo : Pawns)
+	{
+		// Without teams everybody else is an enemy
+		const bool bIsEnemy = PawnInfo.PlayerState != nullptr && PawnInfo.PlayerState != ViewerPS && (TeamNum == INDEX_NONE || PawnInfo.TeamNum != TeamNum);
+		if (!bIsEnemy)
+		{
+			continue;
+		}
+
+		const float CullDistance = FMath::Sqrt(PawnInfo.CullDistanceSquared);
+		const float Distance = FVector::Dist(PawnInfo.Actor->GetActorLocation(), ViewLocation);
+		const float Alpha = (CullDistance > FullRateDistance) ? FMath::Clamp((Distance - FullRateDistance) / (CullDistance - FullRateDistance), 0.f, 1.f) : 0.f;
+		const uint32 Period = FMath::Max<uint32>((uint32)FMath::RoundToInt(PawnInfo.BaseReplicationPeriodFrame * AdaptivePeriodScale * FMath::Lerp(1.f, MaxPeriodScale, Alpha)), 1);
+
+		ConnectionActorInfoMap.FindOrAdd(PawnInfo.Actor).ReplicationPeriodFrame = Period;
+	}
+}
+
+void UShooterReplicationGraphNode_TeamPawns::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+
+	for (const auto& TeamList : TeamPawnLists)
+	{
+		LogActorRepList(DebugInfo, FString::Printf(TEXT("Team[%d]"), TeamList.Key), TeamList.Value);
+	}
+
+	DebugInfo.PopIndent();
+}
+
+// ------------------------------------------------------------------------------
+
+void UShooterReplicationGraphNode_GridSpatialization2D::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterRepGraphGridGather);
+
+	const uint32 StartCycles = FPlatformTime::Cycles();
+
+	Super::GatherActorListsForConnection(Params);
+
+	const uint32 Cycles = FPlatformTime::Cycles() - StartCycles;
+	NumGathers++;
+	GatherCycles += Cycles;
+	MaxGatherCycles = FMath::Max(MaxGatherCycles, Cycles);
+}
+
+void UShooterReplicationGraphNode_GridSpatialization2D::ResetGatherStats()
+{
+	NumGathers = 0;
+	GatherCycles = 0;
+	MaxGatherCycles = 0;
+}
+
+// ------------------------------------------------------------------------------
+
+void UShooterReplicationGraph::PrintGridReport()
+{
+	if (!GridNode)
+	{
+		return;
+	}
+
+	GLog->Logf(TEXT("===================================="));
+	GLog->Logf(TEXT("Shooter Replication Grid"));
+	GLog->Logf(TEXT("===================================="));
+
+	if (GridLevelBounds.IsValid)
+	{
+		GLog->Logf(TEXT("Sized from level bounds %s, typical cull distance %.0f"), *GridLevelBounds.ToString(), GridTypicalCullDistance);
+	}
+	else
+	{
+		GLog->Logf(TEXT("Sized from ShooterRepGraph.CellSize/SpatialBiasX/SpatialBiasY"));
+	}
+	GLog->Logf(TEXT("CellSize %.0f, SpatialBias %s"), GridNode->CellSize, *GridNode->SpatialBias.ToString());
+
+	// Cells are only created once an actor lands in them
+	static const int32 HistogramLimits[] = { 0, 4, 16, 64, 256, MAX_int32 };
+	int32 Histogram[ARRAY_COUNT(HistogramLimits)] = { 0 };
+	int32 NumCells = 0;
+	int32 NumActors = 0;
+	int32 MaxActors = 0;
+
+	TArray<FActorRepListType> CellActors;
+	for (UReplicationGraphNode* ChildNode : GridNode->GetChildNodes())
+	{
+		CellActors.Reset();
+		ChildNode->GetAllActorsInNode_Debugging(CellActors);
+
+		NumCells++;
+		NumActors += CellActors.Num();
+		MaxActors = FMath::Max(MaxActors, CellActors.Num());
+
+		int32 Bucket = 0;
+		while (CellActors.Num() > HistogramLimits[Bucket])
+		{
+			Bucket++;
+		}
+		Histogram[Bucket]++;
+	}
+
+	GLog->Logf(TEXT("%d cells, %d actor entries, %.1f avg, %d max"), NumCells, NumActors, NumCells > 0 ? (float)NumActors / NumCells : 0.f, MaxActors);
+	for (int32 Bucket = 0; Bucket < ARRAY_COUNT(HistogramLimits); Bucket++)
+	{
+		if (Bucket == 0)
+		{
+			GLog->Logf(TEXT("  %-12s %d cells"), TEXT("empty"), Histogram[Bucket]);
+		}
+		else if (HistogramLimits[Bucket] == MAX_int32)
+		{
+			GLog->Logf(TEXT("  %-12s %d cells"), *FString::Printf(TEXT("> %d"), HistogramLimits[Bucket - 1]), Histogram[Bucket]);
+		}
+		else
+		{
+			GLog->Logf(TEXT("  %-12s %d cells"), *FString::Printf(TEXT("%d - %d"), HistogramLimits[Bucket - 1] + 1, HistogramLimits[Bucket]), Histogram[Bucket]);
+		}
+	}
+
+	const double GatherMs = FPlatformTime::ToMilliseconds64(GridNode->GatherCycles);
+	GLog->Logf(TEXT("%u gathers since last report, %.4f ms avg, %.4f ms max"), GridNode->NumGathers,
+		GridNode->NumGathers > 0 ? GatherMs / GridNode->NumGathers : 0.0, FPlatformTime::ToMilliseconds(GridNode->MaxGatherCycles));
+
+	GridNode->ResetGatherStats();
+}
+
+FAutoConsoleCommandWithWorldAndArgs ShooterPrintGridCmd(TEXT("ShooterRepGraph.PrintGrid"), TEXT("Prints the replication grid layout, actors per cell and gather cost since the last call"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		for (TObjectIterator<UShooterReplicationGraph> It; It; ++It)
+		{
+			It->PrintGridReport();
+		}
+	})
+);
+
+// ------------------------------------------------------------------------------
+
 void UShooterReplicationGraph::PrintRepNodePolicies()
 {
 	UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
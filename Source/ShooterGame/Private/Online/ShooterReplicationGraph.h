@@ -8,8 +8,10 @@
 
 class AShooterCharacter;
 class AShooterWeapon;
-class UReplicationGraphNode_GridSpatialization2D;
+class UShooterReplicationGraphNode_GridSpatialization2D;
 class AGameplayDebuggerCategoryReplicator;
+class UShooterReplicationGraphNode_PlayerStateFrequencyLimiter;
+class UShooterReplicationGraphNode_TeamPawns;
 
 DECLARE_LOG_CATEGORY_EXTERN( LogShooterReplicationGraph, Display, All );
 
@@ -17,8 +19,9 @@ DECLARE_LOG_CATEGORY_EXTERN( LogShooterReplicationGraph, Display, All );
 UENUM()
 enum class EClassRepNodeMapping : uint32
 {
-	NotRouted,						// Doesn't map to any node. Used for special case actors that handled by special case nodes (UShooterReplicationGraphNode_PlayerStateFrequencyLimiter)
+	NotRouted,						// Doesn't map to any node. Used for special case actors that handled by special case nodes (UShooterReplicationGraphNode_AlwaysRelevant_ForConnection)
 	RelevantAllConnections,			// Routes to an AlwaysRelevantNode or AlwaysRelevantStreamingLevelNode node
+	PlayerStateFrequencyLimited,	// Routes to the PlayerStateNode (UShooterReplicationGraphNode_PlayerStateFrequencyLimiter)
 	
 	// ONLY SPATIALIZED Enums below here! See UShooterReplicationGraph::IsSpatialized
 
@@ -38,6 +41,8 @@ public:
 	UShooterReplicationGraph();
 
 	virtual void ResetGameWorldState() override;
+	virtual void InitializeActorsInWorld(UWorld* InWorld) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
 
 	virtual void InitGlobalActorClassSettings() override;
 	virtual void InitGlobalGraphNodes() override;
@@ -55,15 +60,25 @@ public:
 	TArray<UClass*>	AlwaysRelevantClasses;
 	
 	UPROPERTY()
-	UReplicationGraphNode_GridSpatialization2D* GridNode;
+	UShooterReplicationGraphNode_GridSpatialization2D* GridNode;
 
 	UPROPERTY()
 	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
 
+	UPROPERTY()
+	UShooterReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode;
+
+	UPROPERTY()
+	UShooterReplicationGraphNode_TeamPawns* TeamPawnsNode;
+
 	TMap<FName, FActorRepListRefView> AlwaysRelevantStreamingLevelActors;
 
 	void OnCharacterEquipWeapon(AShooterCharacter* Character, AShooterWeapon* NewWeapon);
 	void OnCharacterUnEquipWeapon(AShooterCharacter* Character, AShooterWeapon* OldWeapon);
+	void OnCharacterInventoryChange(AShooterCharacter* Character);
+
+	void OnStreamingLevelActorDormancyChange(FActorRepListType Actor, FGlobalActorReplicationInfo& GlobalInfo, ENetDormancy NewValue, ENetDormancy OldValue);
+	void OnStreamingLevelActorDormancyFlush(FActorRepListType Actor, FGlobalActorReplicationInfo& GlobalInfo);
 
 #if WITH_GAMEPLAY_DEBUGGER
 	void OnGameplayDebuggerOwnerChange(AGameplayDebuggerCategoryReplicator* Debugger, APlayerController* OldOwner);
@@ -71,15 +86,91 @@ public:
 
 	void PrintRepNodePolicies();
 
+	/** Logs the grid layout, actors per cell and gather cost since the last report */
+	void PrintGridReport();
+
+	/** Scale currently applied to replication periods to stay within ShooterRepGraph.Adaptive.TargetMs */
+	float GetAdaptivePeriodScale() const { return AdaptivePeriodScale; }
+
 private:
 
 	EClassRepNodeMapping GetMappingPolicy(UClass* Class);
 
+	/** Returns the always relevant node of a connection, if it has one */
+	UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* FindAlwaysRelevantConnectionNode(UNetConnection* NetConnection);
+
+	/** Calls Func on the always relevant node of every connection, pending ones included */
+	void ForEachAlwaysRelevantConnectionNode(TFunctionRef<void(UShooterReplicationGraphNode_AlwaysRelevant_ForConnection*)> Func);
+
+	/** Tells every connection that an actor of an always relevant streaming level may replicate again */
+	void NotifyStreamingLevelActorAwake(FName LevelName, FActorRepListType Actor);
+
 	bool IsSpatialized(EClassRepNodeMapping Mapping) const { return Mapping >= EClassRepNodeMapping::Spatialize_Static; }
 
+	/** Sizes the grid from the bounds of the world's levels and the typical cull distance of its spatialized actors. See ShooterRepGraph.AutoGrid. */
+	void ConfigureGridFromWorld(UWorld* World);
+
+	/** Level bounds the grid was sized from, invalid if it uses the cvar settings */
+	FBox GridLevelBounds;
+
+	/** Median cull distance of the spatialized actors the grid was sized from */
+	float GridTypicalCullDistance = 0.f;
+
+	/** Tracks the time spent replicating and adjusts buckets and periods once per ShooterRepGraph.Adaptive.Interval */
+	void UpdateAdaptiveReplication(float ReplicateMs, float DeltaSeconds);
+
+	/** Applies the bucket count to new and existing dynamic actor bucket nodes */
+	void ApplyDynamicActorFrequencyBuckets(int32 NumBuckets);
+
+	/** Applies the period scale to the adaptive classes and their existing actors on every connection */
+	void ApplyAdaptivePeriodScale(float PeriodScale);
+
+	/** Dynamic spatialized classes, except pawns, with the replication period InitClassReplicationInfo gave them */
+	UPROPERTY()
+	TMap<UClass*, uint32> AdaptiveClassBasePeriods;
+
+	/** Smoothed time spent in ServerReplicateActors */
+	float AdaptiveAverageMs = 0.f;
+
+	float AdaptiveTimeSinceAdjust = 0.f;
+
+	int32 AdaptiveNumBuckets = 0;
+
+	float AdaptivePeriodScale = 1.f;
+
 	TClassMap<EClassRepNodeMapping> ClassRepNodePolicies;
 };
 
+/** What a connection's always relevant list was built from, per viewer */
+struct FShooterAlwaysRelevantViewerInfo
+{
+	TWeakObjectPtr<AActor> Viewer;
+	TWeakObjectPtr<AActor> ViewTarget;
+	TWeakObjectPtr<APawn> Pawn;
+	TWeakObjectPtr<APlayerState> PlayerState;
+
+	/** Pawn and view target whose cull distance was last cleared for this viewer. Kept across rebuilds. */
+	TWeakObjectPtr<AActor> LastCulledPawn;
+	TWeakObjectPtr<AActor> LastCulledViewTarget;
+};
+
+/** An always relevant streaming level visible to a connection */
+struct FShooterAlwaysRelevantStreamingLevel
+{
+	FName LevelName;
+
+	/** Actors of the level not yet known to be dormant on the connection. The level is skipped while this is empty. */
+	TArray<FActorRepListType> AwakeActors;
+
+	/** AwakeActors still has to be filled from the level's full list */
+	bool bNeedsRecount = true;
+
+	explicit FShooterAlwaysRelevantStreamingLevel(FName InLevelName)
+		: LevelName(InLevelName)
+	{
+	}
+};
+
 UCLASS()
 class UShooterReplicationGraphNode_AlwaysRelevant_ForConnection : public UReplicationGraphNode
 {
@@ -100,24 +191,48 @@ public:
 
 	void ResetGameWorldState();
 
+	/** An actor of an always relevant streaming level was added, woken up or flushed and may replicate again */
+	void OnStreamingLevelActorAwake(FName LevelName, FActorRepListType Actor);
+
+	/** An actor of an always relevant streaming level was removed */
+	void OnStreamingLevelActorRemoved(FName LevelName, FActorRepListType Actor);
+
+	/** Rebuild the actor list on the next gather, e.g. because the pawn's inventory changed */
+	void MarkActorListDirty() { bActorListDirty = true; }
+
 #if WITH_GAMEPLAY_DEBUGGER
 	AGameplayDebuggerCategoryReplicator* GameplayDebugger = nullptr;
 #endif
 
 private:
 
-	TArray<FName, TInlineAllocator<64> > AlwaysRelevantStreamingLevelsNeedingReplication;
+	/** Returns true if the viewers, their pawns or player states differ from the ones the actor list was built from */
+	bool HaveViewersChanged(const FConnectionGatherActorListParameters& Params) const;
+
+	/** Rebuilds ReplicationActorList and PlayerStateActorList from the current viewers */
+	void RebuildActorList(const FConnectionGatherActorListParameters& Params);
+
+	/** Gathers the always relevant actors of the visible streaming levels that are not dormant on this connection */
+	void GatherStreamingLevelActors(const FConnectionGatherActorListParameters& Params);
 
+	/** Visible streaming levels, with the actors that may still replicate to this connection */
+	TArray<FShooterAlwaysRelevantStreamingLevel, TInlineAllocator<64> > AlwaysRelevantStreamingLevelsNeedingReplication;
+
+	/** Viewers, view targets, pawns and their inventory. Persistent, only rebuilt when one of them changes. */
 	FActorRepListRefView ReplicationActorList;
 
-	UPROPERTY()
-	AActor* LastPawn = nullptr;
+	/** The viewers' own player states, returned every other frame */
+	FActorRepListRefView PlayerStateActorList;
 
-	/** List of previously (or currently if nothing changed last tick) focused actor data per connection */
-	UPROPERTY()
-	TArray<FAlwaysRelevantActorInfo> PastRelevantActors;
+	/** Viewers the lists were built from, indexed like FConnectionGatherActorListParameters::Viewers */
+	TArray<FShooterAlwaysRelevantViewerInfo, TInlineAllocator<2> > CachedViewers;
 
-	bool bInitializedPlayerState = false;
+#if WITH_GAMEPLAY_DEBUGGER
+	/** Debugger the lists were built with */
+	AGameplayDebuggerCategoryReplicator* CachedGameplayDebugger = nullptr;
+#endif
+
+	bool bActorListDirty = true;
 };
 
 /** This is a specialized node for handling PlayerState replication in a frequency limited fashion. It tracks all player states but only returns a subset of them to the replication driver each frame. */
@@ -126,10 +241,13 @@ class UShooterReplicationGraphNode_PlayerStateFrequencyLimiter : public UReplica
 {
 	GENERATED_BODY()
 
+public:
+
 	UShooterReplicationGraphNode_PlayerStateFrequencyLimiter();
 
-	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override { }
-	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override { return false; }
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override;
+	virtual void NotifyResetAllNetworkActors() override;
 
 	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
 
@@ -141,7 +259,124 @@ class UShooterReplicationGraphNode_PlayerStateFrequencyLimiter : public UReplica
 	int32 TargetActorsPerFrame = 2;
 
 private:
-	
+
+	/** Builds a connection specific list of the most relevant player states that fit in the connection's byte budget. See ShooterRepGraph.PlayerStatePrioritization. */
+	void GatherPrioritizedListForConnection(const FConnectionGatherActorListParameters& Params);
+
+	/** Per connection lists used by the prioritized mode. These are not shared between connections, so they do not benefit from serialization sharing. */
+	TMap<TWeakObjectPtr<UNetReplicationGraphConnection>, FActorRepListRefView> PrioritizedConnectionLists;
+
+	/** Rebuilds a single bucket from the compact PlayerStates array. */
+	void RebuildBucket(int32 BucketIdx);
+
+	/** Compact list of every tracked player state. Bucket N holds the range [N * TargetActorsPerFrame, (N+1) * TargetActorsPerFrame). */
+	TArray<FActorRepListType> PlayerStates;
+
+	/** Index of each tracked player state in PlayerStates, so removal is a swap with the last entry instead of a search. */
+	TMap<FActorRepListType, int32> PlayerStateIndices;
+
 	TArray<FActorRepListRefView> ReplicationActorLists;
 	FActorRepListRefView ForceNetUpdateReplicationActorList;
-};
\ No newline at end of file
+};
+
+/** Spatialization node that measures its own gather cost, see ShooterRepGraph.PrintGrid */
+UCLASS()
+class UShooterReplicationGraphNode_GridSpatialization2D : public UReplicationGraphNode_GridSpatialization2D
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	void ResetGatherStats();
+
+	/** Gathers since the last reset */
+	uint32 NumGathers = 0;
+
+	/** Cycles spent gathering since the last reset */
+	uint64 GatherCycles = 0;
+
+	/** Most cycles spent in a single gather since the last reset */
+	uint32 MaxGatherCycles = 0;
+};
+
+/** A pawn tracked by UShooterReplicationGraphNode_TeamPawns */
+struct FShooterTeamPawnInfo
+{
+	FActorRepListType Actor = nullptr;
+
+	/** Player state and team of the pawn as of the last PrepareForReplication. INDEX_NONE team if it has no player state. */
+	const APlayerState* PlayerState = nullptr;
+	int32 TeamNum = INDEX_NONE;
+
+	/** Class settings the per connection values are scaled from */
+	uint32 BaseReplicationPeriodFrame = 1;
+	float CullDistanceSquared = 0.f;
+	uint8 ActorChannelFrameTimeout = 0;
+};
+
+/** Teammates UShooterReplicationGraphNode_TeamPawns set up for one connection */
+struct FShooterTeamConnectionInfo
+{
+	int32 TeamNum = INDEX_NONE;
+	uint32 TeamListVersion = 0;
+
+	/** Pawns whose cull distance was cleared and channel timeout raised on this connection */
+	TArray<FActorRepListType> Teammates;
+};
+
+/**
+ * Team aware pawn replication. Pawns stay in the GridNode, this node adds on top of it:
+ * teammate pawns are returned at a low, steady frequency at any distance, and enemy pawns replicate less often the further away they are.
+ * Teams come from AShooterPlayerState::GetTeamNum. Player states themselves are still handled by UShooterReplicationGraphNode_PlayerStateFrequencyLimiter.
+ */
+UCLASS()
+class UShooterReplicationGraphNode_TeamPawns : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+
+	UShooterReplicationGraphNode_TeamPawns();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override { }
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+
+	virtual void PrepareForReplication() override;
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+
+	/** Starts tracking a pawn, with the replication settings of its class */
+	void AddPawn(const FNewReplicatedActorInfo& ActorInfo, const FGlobalActorReplicationInfo& GlobalInfo);
+
+private:
+
+	/** Clears the cull distance of the connection's teammates and restores it for former ones */
+	void UpdateTeammatesForConnection(const FConnectionGatherActorListParameters& Params, FShooterTeamConnectionInfo& ConnectionInfo, int32 TeamNum, const APlayerState* ViewerPS);
+
+	/** Sets the connection's replication period of every enemy pawn from its distance to the viewer */
+	void UpdateEnemyFrequenciesForConnection(const FConnectionGatherActorListParameters& Params, int32 TeamNum, const APlayerState* ViewerPS);
+
+	/** Every tracked pawn */
+	TArray<FShooterTeamPawnInfo> Pawns;
+
+	/** Index of each tracked pawn in Pawns */
+	TMap<FActorRepListType, int32> PawnIndices;
+
+	/** Pawns per team, shared by every connection on the team */
+	TMap<int32, FActorRepListRefView> TeamPawnLists;
+
+	/** Bumped whenever TeamPawnLists is rebuilt */
+	uint32 TeamListVersion = 1;
+
+	bool bTeamListsDirty = false;
+
+	/** Does the current game have more than one team? */
+	bool bHasTeams = false;
+
+	TMap<TWeakObjectPtr<UNetReplicationGraphConnection>, FShooterTeamConnectionInfo> ConnectionInfos;
+};
@@ -0,0 +1,149 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterScoreboardStats.h"
+#include "Online/ShooterPlayerState.h"
+
+int32 FShooterScoreboardStatsItem::GetStat(EShooterScoreboardStat::Type Stat) const
+{
+	switch (Stat)
+	{
+		case EShooterScoreboardStat::Kills:			return Kills;
+		case EShooterScoreboardStat::Deaths:		return Deaths;
+		case EShooterScoreboardStat::Score:			return Score;
+		case EShooterScoreboardStat::BulletsFired:	return BulletsFired;
+		case EShooterScoreboardStat::RocketsFired:	return RocketsFired;
+		default:									return 0;
+	}
+}
+
+void FShooterScoreboardStatsItem::PostReplicatedAdd(const FShooterScoreboardStats& InArraySerializer)
+{
+	InArraySerializer.MarkColumnsDirty();
+}
+
+void FShooterScoreboardStatsItem::PostReplicatedChange(const FShooterScoreboardStats& InArraySerializer)
+{
+	InArraySerializer.MarkColumnsDirty();
+}
+
+void FShooterScoreboardStatsItem::PreReplicatedRemove(const FShooterScoreboardStats& InArraySerializer)
+{
+	InArraySerializer.MarkColumnsDirty();
+}
+
+void FShooterScoreboardStats::UpdatePlayer(AShooterPlayerState* PlayerState)
+{
+	int32 Row = Items.IndexOfByPredicate([PlayerState](const FShooterScoreboardStatsItem& Item) { return Item.PlayerState == PlayerState; });
+	if (Row == INDEX_NONE)
+	{
+		Row = Items.AddDefaulted();
+		Items[Row].PlayerState = PlayerState;
+	}
+
+	FShooterScoreboardStatsItem& Item = Items[Row];
+	Item.PlayerId = PlayerState->PlayerId;
+	Item.TeamNum = PlayerState->GetTeamNum();
+	Item.Kills = PlayerState->GetKills();
+	Item.Deaths = PlayerState->GetDeaths();
+	Item.Score = FMath::TruncToInt(PlayerState->GetScore());
+	Item.BulletsFired = PlayerState->GetNumBulletsFired();
+	Item.RocketsFired = PlayerState->GetNumRocketsFired();
+
+	MarkItemDirty(Item);
+	MarkColumnsDirty();
+}
+
+void FShooterScoreboardStats::RemovePlayer(AShooterPlayerState* PlayerState)
+{
+	const int32 Row = Items.IndexOfByPredicate([PlayerState](const FShooterScoreboardStatsItem& Item) { return Item.PlayerState == PlayerState; });
+	if (Row != INDEX_NONE)
+	{
+		Items.RemoveAtSwap(Row);
+		MarkArrayDirty();
+		MarkColumnsDirty();
+	}
+}
+
+void FShooterScoreboardStats::UpdateColumns() const
+{
+	if (!bColumnsDirty)
+	{
+		return;
+	}
+
+	bColumnsDirty = false;
+
+	PlayerStates.Reset(Items.Num());
+	PlayerIds.Reset(Items.Num());
+	TeamNums.Reset(Items.Num());
+	for (int32 StatIdx = 0; StatIdx < EShooterScoreboardStat::Num; StatIdx++)
+	{
+		StatColumns[StatIdx].Reset(Items.Num());
+	}
+
+	for (const FShooterScoreboardStatsItem& Item : Items)
+	{
+		PlayerStates.Add(Item.PlayerState);
+		PlayerIds.Add(Item.PlayerId);
+		TeamNums.Add(Item.TeamNum);
+		for (int32 StatIdx = 0; StatIdx < EShooterScoreboardStat::Num; StatIdx++)
+		{
+			StatColumns[StatIdx].Add(Item.GetStat((EShooterScoreboardStat::Type)StatIdx));
+		}
+	}
+}
+
+int32 FShooterScoreboardStats::Num() const
+{
+	return Items.Num();
+}
+
+int32 FShooterScoreboardStats::FindRow(const AShooterPlayerState* PlayerState) const
+{
+	UpdateColumns();
+	return PlayerState ? PlayerStates.Find(PlayerState) : INDEX_NONE;
+}
+
+AShooterPlayerState* FShooterScoreboardStats::GetPlayerState(int32 Row) const
+{
+	return Items.IsValidIndex(Row) ? Items[Row].PlayerState : NULL;
+}
+
+int32 FShooterScoreboardStats::GetPlayerId(int32 Row) const
+{
+	UpdateColumns();
+	return PlayerIds.IsValidIndex(Row) ? PlayerIds[Row] : INDEX_NONE;
+}
+
+int32 FShooterScoreboardStats::GetTeamNum(int32 Row) const
+{
+	UpdateColumns();
+	return TeamNums.IsValidIndex(Row) ? TeamNums[Row] : INDEX_NONE;
+}
+
+int32 FShooterScoreboardStats::GetStat(int32 Row, EShooterScoreboardStat::Type Stat) const
+{
+	UpdateColumns();
+	return StatColumns[Stat].IsValidIndex(Row) ? StatColumns[Stat][Row] : 0;
+}
+
+int32 FShooterScoreboardStats::GetPlayerStat(const AShooterPlayerState* PlayerState, EShooterScoreboardStat::Type Stat) const
+{
+	return GetStat(FindRow(PlayerState), Stat);
+}
+
+int32 FShooterScoreboardStats::GetTeamTotal(int32 TeamNum, EShooterScoreboardStat::Type Stat) const
+{
+	UpdateColumns();
+
+	const TArray<int32>& Column = StatColumns[Stat];
+
+	int32 Total = 0;
+	for (int32 Row = 0; Row < TeamNums.Num(); Row++)
+	{
+		Total += (TeamNums[Row] == TeamNum) ? Column[Row] : 0;
+	}
+
+	return Total;
+}
@@ -0,0 +1,291 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterSpawnSelector.h"
+#include "Online/ShooterPlayerState.h"
+#include "Bots/ShooterAIController.h"
+#include "GameFramework/PlayerStart.h"
+#include "Engine/PlayerStartPIE.h"
+
+DECLARE_CYCLE_STAT(TEXT("Choose Player Start"), STAT_ChoosePlayerStart, STATGROUP_ShooterGame);
+DECLARE_CYCLE_STAT(TEXT("Spawn Pawn Grid Update"), STAT_SpawnPawnGridUpdate, STATGROUP_ShooterGame);
+
+static int32 UseSpawnSelector = 1;
+FAutoConsoleVariableRef CVarUseSpawnSelector(
+	TEXT("ShooterGame.SpawnSelector"),
+	UseSpawnSelector,
+	TEXT("Choose player starts from cached starts and a per frame pawn grid.")
+	TEXT("0: test every pawn against every start, 1: use the grid"),
+	ECVF_Default);
+
+static float SpawnGridCellSize = 500.0f;
+FAutoConsoleVariableRef CVarSpawnGridCellSize(
+	TEXT("ShooterGame.SpawnGridCellSize"),
+	SpawnGridCellSize,
+	TEXT("Size (uu) of the pawn grid cells used to choose player starts."),
+	ECVF_Default);
+
+static float SpawnDangerRadius = 0.0f;
+FAutoConsoleVariableRef CVarSpawnDangerRadius(
+	TEXT("ShooterGame.SpawnDangerRadius"),
+	SpawnDangerRadius,
+	TEXT("Prefer unoccupied starts with the fewest live enemies within this distance (uu).")
+	TEXT("0: any unoccupied start"),
+	ECVF_Default);
+
+FShooterSpawnSelector::FShooterSpawnSelector()
+	: bHasStarts(false)
+	, MaxPawnRadius(0.0f)
+	, CellSize(SpawnGridCellSize)
+	, LastUpdateFrame(0)
+{
+}
+
+bool FShooterSpawnSelector::IsEnabled()
+{
+	return UseSpawnSelector != 0;
+}
+
+void FShooterSpawnSelector::Reset()
+{
+	Starts.Reset();
+	PIEStart.Reset();
+	AllowedStarts.Reset();
+	bHasStarts = false;
+	LastUpdateFrame = 0;
+}
+
+FIntPoint FShooterSpawnSelector::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void FShooterSpawnSelector::UpdateStarts(UWorld* World)
+{
+	if (bHasStarts)
+	{
+		bool bAllValid = true;
+		for (const FStartInfo& Info : Starts)
+		{
+			bAllValid &= Info.Start.IsValid();
+		}
+
+		if (bAllValid)
+		{
+			return;
+		}
+	}
+
+	Reset();
+	bHasStarts = true;
+
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		APlayerStart* TestSpawn = *It;
+		if (TestSpawn->IsA<APlayerStartPIE>())
+		{
+			// Always prefer the first "Play from Here" PlayerStart, if we find one while in PIE mode
+			PIEStart = TestSpawn;
+			break;
+		}
+
+		FStartInfo& Info = Starts.AddDefaulted_GetRef();
+		Info.Start = TestSpawn;
+		Info.Location = TestSpawn->GetActorLocation();
+	}
+}
+
+void FShooterSpawnSelector::AddPawn(ACharacter* Character, const FVector& Location, float HalfHeight, float Radius)
+{
+	FPawnEntry& Entry = Pawns.AddDefaulted_GetRef();
+	Entry.Character = Character;
+	Entry.Location = Location;
+	Entry.HalfHeight = HalfHeight;
+	Entry.Radius = Radius;
+
+	PawnCells.FindOrAdd(GetCell(Location)).Add(Pawns.Num() - 1);
+	MaxPawnRadius = FMath::Max(MaxPawnRadius, Radius);
+}
+
+void FShooterSpawnSelector::UpdatePawns(UWorld* World)
+{
+	if (LastUpdateFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_SpawnPawnGridUpdate);
+
+	LastUpdateFrame = GFrameCounter;
+	CellSize = FMath::Max(100.0f, SpawnGridCellSize);
+	MaxPawnRadius = 0.0f;
+
+	Pawns.Reset();
+	PawnCells.Reset();
+
+	for (ACharacter* OtherPawn : TActorRange<ACharacter>(World))
+	{
+		const UCapsuleComponent* Capsule = OtherPawn->GetCapsuleComponent();
+		AddPawn(OtherPawn, OtherPawn->GetActorLocation(), Capsule->GetScaledCapsuleHalfHeight(), Capsule->GetScaledCapsuleRadius());
+	}
+}
+
+const TArray<int32>& FShooterSpawnSelector::GetAllowedStarts(AShooterGameMode* GameMode, AController* Player)
+{
+	const AShooterPlayerState* PlayerState = Player ? Cast<AShooterPlayerState>(Player->PlayerState) : NULL;
+	const bool bIsBot = (Cast<AShooterAIController>(Player) != NULL);
+	const FIntPoint FilterKey(PlayerState ? PlayerState->GetTeamNum() : INDEX_NONE, bIsBot ? 1 : 0);
+
+	TArray<int32>* Allowed = AllowedStarts.Find(FilterKey);
+	if (Allowed == nullptr)
+	{
+		Allowed = &AllowedStarts.Add(FilterKey);
+		for (int32 Idx = 0; Idx < Starts.Num(); Idx++)
+		{
+			if (GameMode->IsSpawnpointAllowed(Starts[Idx].Start.Get(), Player))
+			{
+				Allowed->Add(Idx);
+			}
+		}
+	}
+
+	return *Allowed;
+}
+
+bool FShooterSpawnSelector::IsOccupied(const FVector& Location, const ACharacter* PawnTemplate) const
+{
+	const UCapsuleComponent* MyCapsule = PawnTemplate->GetCapsuleComponent();
+	const float MyHalfHeight = MyCapsule->GetScaledCapsuleHalfHeight();
+	const float MyRadius = MyCapsule->GetScaledCapsuleRadius();
+
+	const FIntPoint Center = GetCell(Location);
+	const int32 CellRadius = FMath::CeilToInt((MyRadius + MaxPawnRadius) / CellSize);
+
+	for (int32 X = Center.X - CellRadius; X <= Center.X + CellRadius; X++)
+	{
+		for (int32 Y = Center.Y - CellRadius; Y <= Center.Y + CellRadius; Y++)
+		{
+			const TArray<int32>* CellPawns = PawnCells.Find(FIntPoint(X, Y));
+			if (CellPawns == nullptr)
+			{
+				continue;
+			}
+
+			for (int32 PawnIndex : *CellPawns)
+			{
+				const FPawnEntry& Entry = Pawns[PawnIndex];
+				const float CombinedHeight = (MyHalfHeight + Entry.HalfHeight) * 2.0f;
+				const float CombinedRadius = MyRadius + Entry.Radius;
+
+				// check if player start overlaps this pawn
+				if (FMath::Abs(Location.Z - Entry.Location.Z) < CombinedHeight && (Location - Entry.Location).Size2D() < CombinedRadius)
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+int32 FShooterSpawnSelector::GetDanger(const FVector& Location, AController* Player) const
+{
+	const FIntPoint Center = GetCell(Location);
+	const int32 CellRadius = FMath::CeilToInt(SpawnDangerRadius / CellSize);
+	const float DangerRadiusSq = FMath::Square(SpawnDangerRadius);
+
+	int32 NumEnemies = 0;
+	for (int32 X = Center.X - CellRadius; X <= Center.X + CellRadius; X++)
+	{
+		for (int32 Y = Center.Y - CellRadius; Y <= Center.Y + CellRadius; Y++)
+		{
+			const TArray<int32>* CellPawns = PawnCells.Find(FIntPoint(X, Y));
+			if (CellPawns == nullptr)
+			{
+				continue;
+			}
+
+			for (int32 PawnIndex : *CellPawns)
+			{
+				const FPawnEntry& Entry = Pawns[PawnIndex];
+				const AShooterCharacter* ShooterPawn = Cast<AShooterCharacter>(Entry.Character);
+				if (ShooterPawn && ShooterPawn->IsAlive() && ShooterPawn->IsEnemyFor(Player) &&
+					(Entry.Location - Location).SizeSquared() < DangerRadiusSq)
+				{
+					NumEnemies++;
+				}
+			}
+		}
+	}
+
+	return NumEnemies;
+}
+
+APlayerStart* FShooterSpawnSelector::ChooseStart(AShooterGameMode* GameMode, AController* Player)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ChoosePlayerStart);
+
+	UWorld* World = GameMode->GetWorld();
+	UpdateStarts(World);
+
+	if (PIEStart.IsValid())
+	{
+		return PIEStart.Get();
+	}
+
+	UpdatePawns(World);
+
+	const TSubclassOf<APawn> PawnClass = Cast<AShooterAIController>(Player) ? GameMode->BotPawnClass : GameMode->DefaultPawnClass;
+	const ACharacter* PawnTemplate = PawnClass ? Cast<ACharacter>(PawnClass->GetDefaultObject()) : NULL;
+
+	TArray<int32, TInlineAllocator<16>> PreferredStarts;
+	TArray<int32, TInlineAllocator<16>> FallbackStarts;
+	int32 BestDanger = MAX_int32;
+
+	for (int32 StartIndex : GetAllowedStarts(GameMode, Player))
+	{
+		const FVector& StartLocation = Starts[StartIndex].Location;
+		if (PawnTemplate && !IsOccupied(StartLocation, PawnTemplate))
+		{
+			const int32 Danger = (SpawnDangerRadius > 0.0f) ? GetDanger(StartLocation, Player) : 0;
+			if (Danger < BestDanger)
+			{
+				BestDanger = Danger;
+				PreferredStarts.Reset();
+			}
+			if (Danger == BestDanger)
+			{
+				PreferredStarts.Add(StartIndex);
+			}
+		}
+		else
+		{
+			FallbackStarts.Add(StartIndex);
+		}
+	}
+
+	int32 BestIndex = INDEX_NONE;
+	if (PreferredStarts.Num() > 0)
+	{
+		BestIndex = PreferredStarts[FMath::RandHelper(PreferredStarts.Num())];
+	}
+	else if (FallbackStarts.Num() > 0)
+	{
+		BestIndex = FallbackStarts[FMath::RandHelper(FallbackStarts.Num())];
+	}
+
+	if (BestIndex == INDEX_NONE)
+	{
+		return NULL;
+	}
+
+	// the pawn isn't spawned yet, claim the start so others restarting this frame pick a different one
+	if (PawnTemplate)
+	{
+		const UCapsuleComponent* Capsule = PawnTemplate->GetCapsuleComponent();
+		AddPawn(NULL, Starts[BestIndex].Location, Capsule->GetScaledCapsuleHalfHeight(), Capsule->GetScaledCapsuleRadius());
+	}
+
+	return Starts[BestIndex].Start.Get();
+}
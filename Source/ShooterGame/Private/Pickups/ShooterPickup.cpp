@@ -33,11 +33,33 @@ void AShooterPickup::BeginPlay()
 
 	RespawnPickup();
 
-	// register on pickup list (server only), don't care about unregistering (in FinishDestroy) - no streaming
+	// register on pickup list (server only)
 	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
 	if (GameMode)
 	{
 		GameMode->LevelPickups.Add(this);
+		GameMode->GetPickupRegistry().RegisterPickup(this, GetPickupType(), bIsActive);
+	}
+}
+
+void AShooterPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (GameMode)
+	{
+		GameMode->LevelPickups.Remove(this);
+		GameMode->GetPickupRegistry().UnregisterPickup(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterPickup::UpdateRegistry()
+{
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (GameMode)
+	{
+		GameMode->GetPickupRegistry().SetPickupActive(this, bIsActive);
 	}
 }
 
@@ -52,6 +74,11 @@ bool AShooterPickup::CanBePickedUp(class AShooterCharacter* TestPawn) const
 	return TestPawn && TestPawn->IsAlive();
 }
 
+UClass* AShooterPickup::GetPickupType() const
+{
+	return GetClass();
+}
+
 void AShooterPickup::GivePickupTo(class AShooterCharacter* Pawn)
 {
 }
@@ -68,6 +95,7 @@ void AShooterPickup::PickupOnTouch(class AShooterCharacter* Pawn)
 			if (!IsPendingKill())
 			{
 				bIsActive = false;
+				UpdateRegistry();
 				OnPickedUp();
 
 				if (RespawnTime > 0.0f)
@@ -83,6 +111,7 @@ void AShooterPickup::RespawnPickup()
 {
 	bIsActive = true;
 	PickedUpBy = NULL;
+	UpdateRegistry();
 	OnRespawned();
 
 	TSet<AActor*> OverlappingPawns;
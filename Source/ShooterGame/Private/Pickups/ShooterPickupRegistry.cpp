@@ -0,0 +1,369 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Pickups/ShooterPickupRegistry.h"
+#include "Pickups/ShooterPickup.h"
+#include "Pickups/ShooterPickup_Health.h"
+#include "Weapons/ShooterWeapon_Instant.h"
+#include "Weapons/ShooterWeapon_Projectile.h"
+#include "NavigationSystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pickup Query"), STAT_PickupQuery, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup Path Queries"), STAT_PickupPathQueries, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup Path Cache Hits"), STAT_PickupPathCacheHits, STATGROUP_ShooterGame);
+
+static float PickupRegistryCellSize = 2000.0f;
+FAutoConsoleVariableRef CVarPickupRegistryCellSize(
+	TEXT("ShooterAI.PickupRegistryCellSize"),
+	PickupRegistryCellSize,
+	TEXT("Size (uu) of the grid cells bots use to find nearby pickups, used when the first pickup registers."),
+	ECVF_Default);
+
+static int32 PickupPathCandidates = 4;
+FAutoConsoleVariableRef CVarPickupPathCandidates(
+	TEXT("ShooterAI.PickupPathCandidates"),
+	PickupPathCandidates,
+	TEXT("Number of nearest pickups compared by navmesh path cost.")
+	TEXT("0: straight line distance only"),
+	ECVF_Default);
+
+static float PickupPathCostCacheTime = 10.0f;
+FAutoConsoleVariableRef CVarPickupPathCostCacheTime(
+	TEXT("ShooterAI.PickupPathCostCacheTime"),
+	PickupPathCostCacheTime,
+	TEXT("How long (seconds) a path cost to a pickup is reused."),
+	ECVF_Default);
+
+static float PickupPathCacheCellSize = 500.0f;
+FAutoConsoleVariableRef CVarPickupPathCacheCellSize(
+	TEXT("ShooterAI.PickupPathCacheCellSize"),
+	PickupPathCacheCellSize,
+	TEXT("Path costs are shared by start locations within cells of this size (uu)."),
+	ECVF_Default);
+
+/** upper limit of cached path costs, the cache is emptied when reached */
+static const int32 MaxCachedPathCosts = 4096;
+
+static void BenchmarkPickupRegistry(const TArray<FString>& Args, UWorld* World)
+{
+	const int32 NumPickups = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 200;
+	const int32 NumBots = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 32;
+	FShooterPickupRegistry::RunBenchmark(World, FMath::Max(NumPickups, 1), FMath::Max(NumBots, 1));
+}
+
+FAutoConsoleCommandWithWorldAndArgs CmdBenchmarkPickupRegistry(
+	TEXT("ShooterAI.BenchmarkPickupRegistry"),
+	TEXT("Time nearest ammo queries of the pickup registry against a linear scan. Arguments: [NumPickups=200] [NumBots=32]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(BenchmarkPickupRegistry)
+	);
+
+FShooterPickupRegistry::FShooterPickupRegistry()
+	: CellSize(PickupRegistryCellSize)
+{
+}
+
+FIntPoint FShooterPickupRegistry::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void FShooterPickupRegistry::RegisterPickup(AShooterPickup* Pickup, UClass* TypeClass, bool bActive)
+{
+	if (Pickup && TypeClass && !PickupSlots.Contains(Pickup))
+	{
+		AddEntry(Pickup, TypeClass, Pickup->GetActorLocation(), bActive);
+	}
+}
+
+void FShooterPickupRegistry::AddEntry(AShooterPickup* Pickup, UClass* TypeClass, const FVector& Location, bool bActive)
+{
+	if (Buckets.Num() == 0)
+	{
+		CellSize = FMath::Max(100.0f, PickupRegistryCellSize);
+	}
+
+	int32 BucketIndex = Buckets.IndexOfByPredicate([TypeClass](const FBucket& Bucket) { return Bucket.TypeClass == TypeClass; });
+	if (BucketIndex == INDEX_NONE)
+	{
+		BucketIndex = Buckets.AddDefaulted();
+		Buckets[BucketIndex].TypeClass = TypeClass;
+		Buckets[BucketIndex].MinCell = FIntPoint(MAX_int32, MAX_int32);
+		Buckets[BucketIndex].MaxCell = FIntPoint(MIN_int32, MIN_int32);
+		Buckets[BucketIndex].NumActive = 0;
+	}
+
+	FBucket& Bucket = Buckets[BucketIndex];
+	const int32 EntryIndex = Bucket.Entries.Num();
+
+	FEntry& Entry = Bucket.Entries.AddDefaulted_GetRef();
+	Entry.Pickup = Pickup;
+	Entry.Location = Location;
+	Entry.bActive = bActive;
+	Bucket.NumActive += bActive ? 1 : 0;
+
+	const FIntPoint Cell = GetCell(Location);
+	Bucket.Cells.FindOrAdd(Cell).Add(EntryIndex);
+	Bucket.MinCell = FIntPoint(FMath::Min(Bucket.MinCell.X, Cell.X), FMath::Min(Bucket.MinCell.Y, Cell.Y));
+	Bucket.MaxCell = FIntPoint(FMath::Max(Bucket.MaxCell.X, Cell.X), FMath::Max(Bucket.MaxCell.Y, Cell.Y));
+
+	if (Pickup)
+	{
+		PickupSlots.Add(Pickup, FIntPoint(BucketIndex, EntryIndex));
+	}
+}
+
+void FShooterPickupRegistry::UnregisterPickup(AShooterPickup* Pickup)
+{
+	FIntPoint Slot;
+	if (PickupSlots.RemoveAndCopyValue(Pickup, Slot))
+	{
+		FBucket& Bucket = Buckets[Slot.X];
+		FEntry& Entry = Bucket.Entries[Slot.Y];
+
+		// keep the hole so other entry indices stay valid
+		Bucket.NumActive -= Entry.bActive ? 1 : 0;
+		Bucket.Cells.FindChecked(GetCell(Entry.Location)).Remove(Slot.Y);
+		Entry.Pickup = NULL;
+		Entry.bActive = false;
+
+		for (TMap<TPair<FIntVector, AShooterPickup*>, FCachedPathCost>::TIterator It(PathCostCache); It; ++It)
+		{
+			if (It.Key().Value == Pickup)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
+
+void FShooterPickupRegistry::SetPickupActive(AShooterPickup* Pickup, bool bActive)
+{
+	const FIntPoint* Slot = PickupSlots.Find(Pickup);
+	if (Slot)
+	{
+		FBucket& Bucket = Buckets[Slot->X];
+		FEntry& Entry = Bucket.Entries[Slot->Y];
+		if (Entry.bActive != bActive)
+		{
+			Entry.bActive = bActive;
+			Bucket.NumActive += bActive ? 1 : -1;
+		}
+	}
+}
+
+void FShooterPickupRegistry::FindCandidates(UClass* TypeClass, const FVector& Location, AShooterCharacter* ForPawn, int32 MaxResults, TArray<FCandidate, TInlineAllocator<16>>& OutCandidates) const
+{
+	OutCandidates.Reset();
+
+	const FIntPoint Center = GetCell(Location);
+	auto SortByDistance = [](const FCandidate& A, const FCandidate& B) { return A.DistSq < B.DistSq; };
+
+	for (const FBucket& Bucket : Buckets)
+	{
+		if (Bucket.NumActive == 0 || !Bucket.TypeClass->IsChildOf(TypeClass))
+		{
+			continue;
+		}
+
+		const int32 FirstCandidate = OutCandidates.Num();
+		const int32 MaxRing = FMath::Max(
+			FMath::Max(FMath::Abs(Bucket.MinCell.X - Center.X), FMath::Abs(Bucket.MaxCell.X - Center.X)),
+			FMath::Max(FMath::Abs(Bucket.MinCell.Y - Center.Y), FMath::Abs(Bucket.MaxCell.Y - Center.Y)));
+
+		// search rings of cells around the query cell until nothing closer than the worst kept result can be left
+		for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+		{
+			for (int32 X = Center.X - Ring; X <= Center.X + Ring; X++)
+			{
+				// only the border of the square is new in this ring
+				const int32 StepY = (X == Center.X - Ring || X == Center.X + Ring) ? 1 : FMath::Max(1, 2 * Ring);
+				for (int32 Y = Center.Y - Ring; Y <= Center.Y + Ring; Y += StepY)
+				{
+					const TArray<int32>* CellEntries = Bucket.Cells.Find(FIntPoint(X, Y));
+					if (CellEntries == nullptr)
+					{
+						continue;
+					}
+
+					for (int32 EntryIndex : *CellEntries)
+					{
+						const FEntry& Entry = Bucket.Entries[EntryIndex];
+						if (!Entry.bActive || (Entry.Pickup && ForPawn && !Entry.Pickup->CanBePickedUp(ForPawn)))
+						{
+							continue;
+						}
+
+						FCandidate& Candidate = OutCandidates.AddDefaulted_GetRef();
+						Candidate.Entry = &Entry;
+						Candidate.DistSq = (Entry.Location - Location).SizeSquared();
+					}
+				}
+			}
+
+			const int32 NumFound = OutCandidates.Num() - FirstCandidate;
+			if (NumFound >= MaxResults)
+			{
+				// every cell outside this ring is at least Ring cells away from the query location
+				Sort(OutCandidates.GetData() + FirstCandidate, NumFound, SortByDistance);
+				if (OutCandidates[FirstCandidate + MaxResults - 1].DistSq <= FMath::Square(Ring * CellSize))
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	OutCandidates.Sort(SortByDistance);
+	if (OutCandidates.Num() > MaxResults)
+	{
+		OutCandidates.SetNum(MaxResults, false);
+	}
+}
+
+float FShooterPickupRegistry::GetPathCost(UWorld* World, const FVector& Location, const FEntry& Entry)
+{
+	const float PathCellSize = FMath::Max(100.0f, PickupPathCacheCellSize);
+	const FIntVector StartCell(FMath::FloorToInt(Location.X / PathCellSize), FMath::FloorToInt(Location.Y / PathCellSize), FMath::FloorToInt(Location.Z / PathCellSize));
+	const TPair<FIntVector, AShooterPickup*> Key(StartCell, Entry.Pickup);
+	const float TimeSeconds = World->GetTimeSeconds();
+
+	const FCachedPathCost* Cached = PathCostCache.Find(Key);
+	if (Cached && TimeSeconds - Cached->Time < PickupPathCostCacheTime)
+	{
+		INC_DWORD_STAT(STAT_PickupPathCacheHits);
+		return Cached->Cost;
+	}
+
+	INC_DWORD_STAT(STAT_PickupPathQueries);
+
+	// unreachable pickups are only chosen when nothing is reachable
+	float PathCost = 0.0f;
+	const float Cost = (UNavigationSystemV1::GetPathCost(World, Location, Entry.Location, PathCost) == ENavigationQueryResult::Success) ? PathCost : MAX_FLT;
+
+	if (PathCostCache.Num() >= MaxCachedPathCosts)
+	{
+		PathCostCache.Reset();
+	}
+
+	FCachedPathCost& NewCached = PathCostCache.Add(Key);
+	NewCached.Cost = Cost;
+	NewCached.Time = TimeSeconds;
+
+	return Cost;
+}
+
+AShooterPickup* FShooterPickupRegistry::FindNearestPickup(UWorld* World, UClass* TypeClass, const FVector& Location, AShooterCharacter* ForPawn)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PickupQuery);
+
+	TArray<FCandidate, TInlineAllocator<16>> Candidates;
+	FindCandidates(TypeClass, Location, ForPawn, FMath::Max(PickupPathCandidates, 1), Candidates);
+
+	if (Candidates.Num() == 0)
+	{
+		return NULL;
+	}
+
+	if (PickupPathCandidates <= 0)
+	{
+		return Candidates[0].Entry->Pickup;
+	}
+
+	const FEntry* BestEntry = NULL;
+	float BestCost = MAX_FLT;
+
+	for (const FCandidate& Candidate : Candidates)
+	{
+		// a path is never shorter than the straight line
+		if (BestEntry && Candidate.DistSq >= FMath::Square(BestCost))
+		{
+			break;
+		}
+
+		const float Cost = GetPathCost(World, Location, *Candidate.Entry);
+		if (Cost < BestCost)
+		{
+			BestCost = Cost;
+			BestEntry = Candidate.Entry;
+		}
+	}
+
+	return BestEntry ? BestEntry->Pickup : Candidates[0].Entry->Pickup;
+}
+
+void FShooterPickupRegistry::RunBenchmark(UWorld* World, int32 NumPickups, int32 NumBots)
+{
+	// synthetic pickups spread over a large level, a quarter of them respawning
+	FShooterPickupRegistry Registry;
+	FRandomStream Random(NumPickups * 31 + NumBots);
+	const FBox LevelBounds(FVector(-10000.0f, -10000.0f, 0.0f), FVector(10000.0f, 10000.0f, 1000.0f));
+
+	UClass* const TypeClasses[] = { AShooterWeapon_Instant::StaticClass(), AShooterWeapon_Projectile::StaticClass(), AShooterPickup_Health::StaticClass() };
+	for (int32 Idx = 0; Idx < NumPickups; Idx++)
+	{
+		Registry.AddEntry(NULL, TypeClasses[Idx % ARRAY_COUNT(TypeClasses)], Random.RandPointInBox(LevelBounds), Random.FRand() < 0.75f);
+	}
+
+	TArray<FVector> BotLocations;
+	for (int32 Idx = 0; Idx < NumBots; Idx++)
+	{
+		BotLocations.Add(Random.RandPointInBox(LevelBounds));
+	}
+
+	// every bot queries nearest ammo for its instant hit weapon, repeated to get measurable times
+	const int32 NumRounds = 100;
+	UClass* const QueryClass = AShooterWeapon_Instant::StaticClass();
+	TArray<const FEntry*> IndexedResults;
+	TArray<const FEntry*> LinearResults;
+	TArray<FCandidate, TInlineAllocator<16>> Candidates;
+
+	const double IndexedStartTime = FPlatformTime::Seconds();
+	for (int32 Round = 0; Round < NumRounds; Round++)
+	{
+		IndexedResults.Reset();
+		for (const FVector& BotLocation : BotLocations)
+		{
+			Registry.FindCandidates(QueryClass, BotLocation, NULL, 1, Candidates);
+			IndexedResults.Add(Candidates.Num() > 0 ? Candidates[0].Entry : NULL);
+		}
+	}
+	const double IndexedTime = FPlatformTime::Seconds() - IndexedStartTime;
+
+	const double LinearStartTime = FPlatformTime::Seconds();
+	for (int32 Round = 0; Round < NumRounds; Round++)
+	{
+		LinearResults.Reset();
+		for (const FVector& BotLocation : BotLocations)
+		{
+			const FEntry* BestEntry = NULL;
+			float BestDistSq = MAX_FLT;
+			for (const FBucket& Bucket : Registry.Buckets)
+			{
+				if (Bucket.TypeClass->IsChildOf(QueryClass))
+				{
+					for (const FEntry& Entry : Bucket.Entries)
+					{
+						const float DistSq = (Entry.Location - BotLocation).SizeSquared();
+						if (Entry.bActive && DistSq < BestDistSq)
+						{
+							BestDistSq = DistSq;
+							BestEntry = &Entry;
+						}
+					}
+				}
+			}
+			LinearResults.Add(BestEntry);
+		}
+	}
+	const double LinearTime = FPlatformTime::Seconds() - LinearStartTime;
+
+	int32 NumMismatches = 0;
+	for (int32 Idx = 0; Idx < NumBots; Idx++)
+	{
+		NumMismatches += (IndexedResults[Idx] != LinearResults[Idx]) ? 1 : 0;
+	}
+
+	const int32 NumQueries = NumRounds * NumBots;
+	UE_LOG(LogShooter, Log, TEXT("Pickup registry benchmark: %d pickups, %d bots, %d queries. Registry %.3f us/query, linear scan %.3f us/query, %d mismatches."),
+		NumPickups, NumBots, NumQueries, IndexedTime * 1000000.0 / NumQueries, LinearTime * 1000000.0 / NumQueries, NumMismatches);
+}
@@ -15,6 +15,11 @@ bool AShooterPickup_Ammo::IsForWeapon(UClass* WeaponClass)
 	return WeaponType->IsChildOf(WeaponClass);
 }
 
+UClass* AShooterPickup_Ammo::GetPickupType() const
+{
+	return WeaponType ? *WeaponType : GetClass();
+}
+
 bool AShooterPickup_Ammo::CanBePickedUp(AShooterCharacter* TestPawn) const
 {
 	AShooterWeapon* TestWeapon = (TestPawn ? TestPawn->FindWeapon(WeaponType) : NULL);
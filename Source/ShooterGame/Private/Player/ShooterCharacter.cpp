@@ -8,7 +8,6 @@
 #include "Animation/AnimMontage.h"
 #include "Animation/AnimInstance.h"
 #include "Sound/SoundNodeLocalPlayer.h"
-#include "AudioThread.h"
 
 static int32 NetVisualizeRelevancyTestPoints = 0;
 FAutoConsoleVariableRef CVarNetVisualizeRelevancyTestPoints(
@@ -27,8 +26,38 @@ FAutoConsoleVariableRef CVarNetEnablePauseRelevancy(
 	TEXT("0: Disable, 1: Enable"),
 	ECVF_Cheat);
 
+static float NetPauseRelevancyCacheTime = 0.1f;
+FAutoConsoleVariableRef CVarNetPauseRelevancyCacheTime(
+	TEXT("p.NetPauseRelevancyCacheTime"),
+	NetPauseRelevancyCacheTime,
+	TEXT("How long (seconds) a pause relevancy line of sight result is reused for a viewer. Refreshes are staggered over this period.")
+	TEXT("0: Trace every time"),
+	ECVF_Cheat);
+
+static int32 NetPauseRelevancyAsyncTraces = 0;
+FAutoConsoleVariableRef CVarNetPauseRelevancyAsyncTraces(
+	TEXT("p.NetPauseRelevancyAsyncTraces"),
+	NetPauseRelevancyAsyncTraces,
+	TEXT("Refresh cached pause relevancy results with async traces. Results are one frame late.")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Cheat);
+
+static int32 NetEnableHitRewind = 1;
+FAutoConsoleVariableRef CVarNetEnableHitRewind(
+	TEXT("p.NetEnableHitRewind"),
+	NetEnableHitRewind,
+	TEXT("Record character hit boxes on the server so client side hits are verified against where the client saw the target.")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+DECLARE_CYCLE_STAT(TEXT("Character Tick"), STAT_ShooterCharacterTick, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pause Relevancy Traces"), STAT_PauseRelevancyTraces, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pause Relevancy Cache Hits"), STAT_PauseRelevancyCacheHits, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pause Relevancy Cache Misses"), STAT_PauseRelevancyCacheMisses, STATGROUP_ShooterGame);
+
 FOnShooterCharacterEquipWeapon AShooterCharacter::NotifyEquipWeapon;
 FOnShooterCharacterUnEquipWeapon AShooterCharacter::NotifyUnEquipWeapon;
+FOnShooterCharacterInventoryChange AShooterCharacter::NotifyInventoryChange;
 
 AShooterCharacter::AShooterCharacter(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer.SetDefaultSubobjectClass<UShooterCharacterMovement>(ACharacter::CharacterMovementComponentName))
@@ -67,6 +96,10 @@ AShooterCharacter::AShooterCharacter(const FObjectInitializer& ObjectInitializer
 
 	BaseTurnRate = 45.f;
 	BaseLookUpRate = 45.f;
+
+	LastPauseReplicationRequestId = 0;
+	bPublishedLocallyControlled = false;
+	HitHistoryHead = INDEX_NONE;
 }
 
 void AShooterCharacter::PostInitializeComponents()
@@ -79,6 +112,8 @@ void AShooterCharacter::PostInitializeComponents()
 
 		// Needs to happen after character is added to repgraph
 		GetWorldTimerManager().SetTimerForNextTick(this, &AShooterCharacter::SpawnDefaultInventory);
+
+		PauseReplicationTraceDelegate.BindUObject(this, &AShooterCharacter::OnPauseReplicationTraceDone);
 	}
 
 	// set initial mesh visibility (3rd person view)
@@ -121,6 +156,8 @@ void AShooterCharacter::PawnClientRestart()
 	// reattach weapon if needed
 	SetCurrentWeapon(CurrentWeapon);
 
+	UpdateLocallyControlledActorCache();
+
 	// set team colors for 1st person view
 	UMaterialInstanceDynamic* Mesh1PMID = Mesh1P->CreateAndSetMaterialInstanceDynamic(0);
 	UpdateTeamColors(Mesh1PMID);
@@ -132,6 +169,22 @@ void AShooterCharacter::PossessedBy(class AController* InController)
 
 	// [server] as soon as PlayerState is assigned, set team colors of this pawn for local player
 	UpdateTeamColorsAllMIDs();
+
+	UpdateLocallyControlledActorCache();
+}
+
+void AShooterCharacter::UnPossessed()
+{
+	Super::UnPossessed();
+
+	UpdateLocallyControlledActorCache();
+}
+
+void AShooterCharacter::OnRep_Controller()
+{
+	Super::OnRep_Controller();
+
+	UpdateLocallyControlledActorCache();
 }
 
 void AShooterCharacter::OnRep_PlayerState()
@@ -608,6 +661,8 @@ void AShooterCharacter::AddWeapon(AShooterWeapon* Weapon)
 	{
 		Weapon->OnEnterInventory(this);
 		Inventory.AddUnique(Weapon);
+
+		NotifyInventoryChange.Broadcast(this);
 	}
 }
 
@@ -617,6 +672,8 @@ void AShooterCharacter::RemoveWeapon(AShooterWeapon* Weapon)
 	{
 		Weapon->OnLeaveInventory();
 		Inventory.RemoveSingle(Weapon);
+
+		NotifyInventoryChange.Broadcast(this);
 	}
 }
 
@@ -1075,7 +1132,19 @@ bool AShooterCharacter::IsRunning() const
 
 void AShooterCharacter::Tick(float DeltaSeconds)
 {
+	SCOPE_CYCLE_COUNTER(STAT_ShooterCharacterTick);
+
 	Super::Tick(DeltaSeconds);
+
+	if (NetEnableHitRewind == 1 && GetLocalRole() == ROLE_Authority && GetNetMode() != NM_Standalone && !bIsDying)
+	{
+		RecordHitHistory();
+	}
+	else if (HasHitHistory())
+	{
+		// history that isn't kept up to date would rewind to stale hit boxes and reject valid hits
+		ClearHitHistory();
+	}
 		
 	if (bWantsToRunToggled && !IsRunning())
 	{
@@ -1122,37 +1191,136 @@ void AShooterCharacter::Tick(float DeltaSeconds)
 		UpdateRunSounds();
 	}
 
-	const APlayerController* PC = Cast<APlayerController>(GetController());
-	const bool bLocallyControlled = (PC ? PC->IsLocalController() : false);
-	const uint32 UniqueID = GetUniqueID();
-	FAudioThread::RunCommandOnAudioThread([UniqueID, bLocallyControlled]()
-	{
-	    USoundNodeLocalPlayer::GetLocallyControlledActorCache().Add(UniqueID, bLocallyControlled);
-	});
-	
-	TArray<FVector> PointsToTest;
-	BuildPauseReplicationCheckPoints(PointsToTest);
-
 	if (NetVisualizeRelevancyTestPoints == 1)
 	{
-		for (FVector PointToTest : PointsToTest)
+		FVector PointsToTest[NumPauseReplicationCheckPoints];
+		BuildPauseReplicationCheckPoints(PointsToTest);
+
+		for (const FVector& PointToTest : PointsToTest)
 		{
 			DrawDebugSphere(GetWorld(), PointToTest, 10.0f, 8, FColor::Red);
 		}
 	}
 }
 
+void AShooterCharacter::RecordHitHistory()
+{
+	HitHistoryHead = (HitHistoryHead + 1) % HitHistorySize;
+
+	FShooterHitSnapshot& Snapshot = HitHistory[HitHistoryHead];
+	Snapshot.Time = GetWorld()->GetTimeSeconds();
+	Snapshot.HitBox = GetMesh()->Bounds.GetBox();
+}
+
+void AShooterCharacter::ClearHitHistory()
+{
+	// unset entries end the walk in GetRewoundHitBox, so snapshots from before a pause are never interpolated
+	for (FShooterHitSnapshot& Snapshot : HitHistory)
+	{
+		Snapshot = FShooterHitSnapshot();
+	}
+
+	HitHistoryHead = INDEX_NONE;
+}
+
+bool AShooterCharacter::GetRewoundHitBox(float Time, FBox& OutHitBox) const
+{
+	if (HitHistoryHead == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Walk back from the newest snapshot to the first one recorded at or before Time
+	const FShooterHitSnapshot* Newer = &HitHistory[HitHistoryHead];
+	if (Time >= Newer->Time)
+	{
+		OutHitBox = Newer->HitBox;
+		return true;
+	}
+
+	for (int32 Age = 1; Age < HitHistorySize; ++Age)
+	{
+		const FShooterHitSnapshot& Older = HitHistory[(HitHistoryHead - Age + HitHistorySize) % HitHistorySize];
+		if (Older.Time < 0.f)
+		{
+			// History isn't full yet, use the oldest entry we have
+			break;
+		}
+
+		if (Older.Time <= Time)
+		{
+			const float Alpha = (Newer->Time > Older.Time) ? (Time - Older.Time) / (Newer->Time - Older.Time) : 0.f;
+			OutHitBox = FBox(FMath::Lerp(Older.HitBox.Min, Newer->HitBox.Min, Alpha), FMath::Lerp(Older.HitBox.Max, Newer->HitBox.Max, Alpha));
+			return true;
+		}
+
+		Newer = &Older;
+	}
+
+	OutHitBox = Newer->HitBox;
+	return true;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkHitRewindCmd(TEXT("ShooterGame.BenchmarkHitRewind"), TEXT("[server] Times <Queries> rewound hit box lookups per character and logs the average cost"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		int32 NumQueries = 1000;
+		if (Args.Num() > 0)
+		{
+			LexTryParseString<int32>(NumQueries, *Args[0]);
+		}
+
+		const float ServerTime = World->GetTimeSeconds();
+		FRandomStream RandomStream(0);
+
+		int32 NumCharacters = 0;
+		int32 NumInside = 0;
+		const double StartTime = FPlatformTime::Seconds();
+		for (TActorIterator<AShooterCharacter> It(World); It; ++It)
+		{
+			if (!It->HasHitHistory())
+			{
+				continue;
+			}
+
+			++NumCharacters;
+			for (int32 i = 0; i < NumQueries; ++i)
+			{
+				FBox HitBox;
+				if (It->GetRewoundHitBox(ServerTime - RandomStream.FRandRange(0.f, 0.4f), HitBox) && HitBox.ExpandBy(30.f).IsInside(It->GetActorLocation()))
+				{
+					++NumInside;
+				}
+			}
+		}
+		const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+
+		const int32 TotalQueries = FMath::Max(1, NumCharacters * NumQueries);
+		UE_LOG(LogShooter, Display, TEXT("BenchmarkHitRewind: %d characters, %d queries, %.3f ms total, %.1f ns/query, %d inside"), NumCharacters, TotalQueries, ElapsedTime * 1000.0, ElapsedTime * 1e9 / TotalQueries, NumInside);
+	})
+);
+
+void AShooterCharacter::UpdateLocallyControlledActorCache()
+{
+	const APlayerController* PC = Cast<APlayerController>(GetController());
+	const bool bLocallyControlled = (PC ? PC->IsLocalController() : false);
+	if (bLocallyControlled == (bPublishedLocallyControlled != 0))
+	{
+		return;
+	}
+
+	bPublishedLocallyControlled = bLocallyControlled;
+
+	USoundNodeLocalPlayer::SetLocallyControlled(GetUniqueID(), bLocallyControlled);
+}
+
 void AShooterCharacter::BeginDestroy()
 {
 	Super::BeginDestroy();
 
 	if (!GExitPurge)
 	{
-		const uint32 UniqueID = GetUniqueID();
-		FAudioThread::RunCommandOnAudioThread([UniqueID]()
-		{
-			USoundNodeLocalPlayer::GetLocallyControlledActorCache().Remove(UniqueID);
-		});
+		USoundNodeLocalPlayer::RemoveLocallyControlled(GetUniqueID());
 	}
 }
 
@@ -1224,23 +1392,125 @@ bool AShooterCharacter::IsReplicationPausedForConnection(const FNetViewer& Conne
 		FCollisionQueryParams CollisionParams(SCENE_QUERY_STAT(LineOfSight), true, PC->GetPawn());
 		CollisionParams.AddIgnoredActor(this);
 
-		TArray<FVector> PointsToTest;
-		BuildPauseReplicationCheckPoints(PointsToTest);
+		if (NetPauseRelevancyCacheTime <= 0.f)
+		{
+			INC_DWORD_STAT(STAT_PauseRelevancyCacheMisses);
+			return !IsVisibleFromViewPoint(ViewLocation, CollisionParams);
+		}
+
+		const float TimeSeconds = GetWorld()->GetTimeSeconds();
 
-		for (FVector PointToTest : PointsToTest)
+		FPauseReplicationVisibility* Visibility = PauseReplicationCache.Find(PC);
+		if (Visibility == nullptr)
 		{
-			if (!GetWorld()->LineTraceTestByChannel(PointToTest, ViewLocation, ECC_Visibility, CollisionParams))
+			// New viewer, a good time to forget the ones that left
+			for (auto It = PauseReplicationCache.CreateIterator(); It; ++It)
 			{
-				return false;
+				if (!It.Key().IsValid())
+				{
+					It.RemoveCurrent();
+				}
 			}
+
+			Visibility = &PauseReplicationCache.Add(PC);
+
+			// Spread the refreshes of all (viewer, pawn) pairs over the cache period so they don't all expire on the same frame
+			const uint32 StaggerSlot = HashCombine(GetTypeHash(PC), GetUniqueID()) % 16;
+			Visibility->NextRefreshTime = TimeSeconds + NetPauseRelevancyCacheTime * (StaggerSlot / 16.f);
+			Visibility->bPaused = !IsVisibleFromViewPoint(ViewLocation, CollisionParams);
+
+			INC_DWORD_STAT(STAT_PauseRelevancyCacheMisses);
+			return Visibility->bPaused;
 		}
 
-		return true;
+		if (TimeSeconds >= Visibility->NextRefreshTime && Visibility->PendingRequestId == 0)
+		{
+			Visibility->NextRefreshTime = TimeSeconds + NetPauseRelevancyCacheTime;
+
+			if (NetPauseRelevancyAsyncTraces == 1)
+			{
+				// Keep using the previous result until the traces come back
+				RequestAsyncPauseReplicationTest(*Visibility, ViewLocation, CollisionParams);
+			}
+			else
+			{
+				INC_DWORD_STAT(STAT_PauseRelevancyCacheMisses);
+				Visibility->bPaused = !IsVisibleFromViewPoint(ViewLocation, CollisionParams);
+				return Visibility->bPaused;
+			}
+		}
+
+		INC_DWORD_STAT(STAT_PauseRelevancyCacheHits);
+		return Visibility->bPaused;
 	}
 
 	return false;
 }
 
+bool AShooterCharacter::IsVisibleFromViewPoint(const FVector& ViewLocation, const FCollisionQueryParams& CollisionParams) const
+{
+	FVector PointsToTest[NumPauseReplicationCheckPoints];
+	BuildPauseReplicationCheckPoints(PointsToTest);
+
+	for (const FVector& PointToTest : PointsToTest)
+	{
+		INC_DWORD_STAT(STAT_PauseRelevancyTraces);
+		if (!GetWorld()->LineTraceTestByChannel(PointToTest, ViewLocation, ECC_Visibility, CollisionParams))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void AShooterCharacter::RequestAsyncPauseReplicationTest(FPauseReplicationVisibility& Visibility, const FVector& ViewLocation, const FCollisionQueryParams& CollisionParams)
+{
+	FVector PointsToTest[NumPauseReplicationCheckPoints];
+	BuildPauseReplicationCheckPoints(PointsToTest);
+
+	// 0 means "no request"
+	if (++LastPauseReplicationRequestId == 0)
+	{
+		++LastPauseReplicationRequestId;
+	}
+
+	Visibility.PendingRequestId = LastPauseReplicationRequestId;
+	Visibility.PendingTraceCount = NumPauseReplicationCheckPoints;
+	Visibility.bPendingVisible = false;
+
+	for (const FVector& PointToTest : PointsToTest)
+	{
+		INC_DWORD_STAT(STAT_PauseRelevancyTraces);
+		GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Test, PointToTest, ViewLocation, ECC_Visibility, CollisionParams, FCollisionResponseParams::DefaultResponseParam, &PauseReplicationTraceDelegate, Visibility.PendingRequestId);
+	}
+}
+
+void AShooterCharacter::OnPauseReplicationTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	for (auto& Pair : PauseReplicationCache)
+	{
+		FPauseReplicationVisibility& Visibility = Pair.Value;
+		if (Visibility.PendingRequestId != TraceDatum.UserData)
+		{
+			continue;
+		}
+
+		// Test traces only report a hit when they are blocked
+		if (TraceDatum.OutHits.Num() == 0)
+		{
+			Visibility.bPendingVisible = true;
+		}
+
+		if (--Visibility.PendingTraceCount == 0)
+		{
+			Visibility.bPaused = !Visibility.bPendingVisible;
+			Visibility.PendingRequestId = 0;
+		}
+		return;
+	}
+}
+
 void AShooterCharacter::OnReplicationPausedChanged(bool bIsReplicationPaused)
 {
 	GetMesh()->SetHiddenInGame(bIsReplicationPaused, true);
@@ -1324,21 +1594,21 @@ void AShooterCharacter::UpdateTeamColorsAllMIDs()
 	}
 }
 
-void AShooterCharacter::BuildPauseReplicationCheckPoints(TArray<FVector>& RelevancyCheckPoints)
+void AShooterCharacter::BuildPauseReplicationCheckPoints(FVector (&RelevancyCheckPoints)[NumPauseReplicationCheckPoints]) const
 {
 	FBoxSphereBounds Bounds = GetCapsuleComponent()->CalcBounds(GetCapsuleComponent()->GetComponentTransform());
 	FBox BoundingBox = Bounds.GetBox();
 	float XDiff = Bounds.BoxExtent.X * 2;
 	float YDiff = Bounds.BoxExtent.Y * 2;
 
-	RelevancyCheckPoints.Add(BoundingBox.Min);
-	RelevancyCheckPoints.Add(FVector(BoundingBox.Min.X + XDiff, BoundingBox.Min.Y, BoundingBox.Min.Z));
-	RelevancyCheckPoints.Add(FVector(BoundingBox.Min.X, BoundingBox.Min.Y + YDiff, BoundingBox.Min.Z));
-	RelevancyCheckPoints.Add(FVector(BoundingBox.Min.X + XDiff, BoundingBox.Min.Y + YDiff, BoundingBox.Min.Z));
-	RelevancyCheckPoints.Add(FVector(BoundingBox.Max.X - XDiff, BoundingBox.Max.Y, BoundingBox.Max.Z));
-	RelevancyCheckPoints.Add(FVector(BoundingBox.Max.X, BoundingBox.Max.Y - YDiff, BoundingBox.Max.Z));
-	RelevancyCheckPoints.Add(FVector(BoundingBox.Max.X - XDiff, BoundingBox.Max.Y - YDiff, BoundingBox.Max.Z));
-	RelevancyCheckPoints.Add(BoundingBox.Max);
+	RelevancyCheckPoints[0] = BoundingBox.Min;
+	RelevancyCheckPoints[1] = FVector(BoundingBox.Min.X + XDiff, BoundingBox.Min.Y, BoundingBox.Min.Z);
+	RelevancyCheckPoints[2] = FVector(BoundingBox.Min.X, BoundingBox.Min.Y + YDiff, BoundingBox.Min.Z);
+	RelevancyCheckPoints[3] = FVector(BoundingBox.Min.X + XDiff, BoundingBox.Min.Y + YDiff, BoundingBox.Min.Z);
+	RelevancyCheckPoints[4] = FVector(BoundingBox.Max.X - XDiff, BoundingBox.Max.Y, BoundingBox.Max.Z);
+	RelevancyCheckPoints[5] = FVector(BoundingBox.Max.X, BoundingBox.Max.Y - YDiff, BoundingBox.Max.Z);
+	RelevancyCheckPoints[6] = FVector(BoundingBox.Max.X - XDiff, BoundingBox.Max.Y - YDiff, BoundingBox.Max.Z);
+	RelevancyCheckPoints[7] = BoundingBox.Max;
 }
 
 //////////////////////////////////////////////////////////////////////////
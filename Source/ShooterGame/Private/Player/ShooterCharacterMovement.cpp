@@ -4,6 +4,30 @@
 #include "Kismet/KismetMathLibrary.h"
 #include "Player/ShooterCharacterMovement.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Movement Corrections"), STAT_MovementCorrections, STATGROUP_ShooterGame);
+DECLARE_CYCLE_STAT(TEXT("Wall Run Probe"), STAT_WallRunProbe, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wall Run Probe Sweeps"), STAT_WallRunProbeSweeps, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wall Run Probe Cache Hits"), STAT_WallRunProbeCacheHits, STATGROUP_ShooterGame);
+
+/** Step of the jetpack fuel model, fuel changes in whole steps of move time */
+static const float JetpackFuelStepTime = 1.0f / 60.0f;
+
+/** Number of JetpackCurve samples */
+static const int32 JetpackCurveTableSize = 128;
+
+/** Number of client moves remembered for fuel reconciliation */
+static const int32 FuelHistorySize = 64;
+
+/** Quantized fuel difference the client accepts without correcting */
+static const int32 FuelCorrectionTolerance = 2;
+
+/** Ability inputs sent in the saved move compressed flags */
+enum EShooterMoveFlags {
+	SHOOTERFLAG_Teleport = FSavedMove_Character::FLAG_Custom_0,
+	SHOOTERFLAG_Jetpack = FSavedMove_Character::FLAG_Custom_1,
+	SHOOTERFLAG_WallRun = FSavedMove_Character::FLAG_Custom_2,
+};
+
 //----------------------------------------------------------------------//
 // UPawnMovementComponent
 //----------------------------------------------------------------------//
@@ -18,8 +42,13 @@ void UShooterCharacterMovement::BeginPlay() {
 
 	JetpackElapsedTime = 0.0f;
 	ActualFuel = JetpackFuel;
+	FuelStepRemainder = 0.0f;
+	BuildJetpackCurveTable();
 	WallRunElapsedTime = 0.0f;
 	HoldJumpButtonElapsedTime = 0.0f;
+
+	WallProbeParams = FCollisionQueryParams(SCENE_QUERY_STAT(WallRunProbe), false, GetOwner());
+
 	if (JetpackTimeConsume <= 0.0f) { // avoid division by 0
 		JetpackTimeConsume = 1.0f;
 	}
@@ -28,9 +57,6 @@ void UShooterCharacterMovement::BeginPlay() {
 void UShooterCharacterMovement::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	// Jetpack
-	RecoverJetpackFuel(DeltaTime);
-
 	// Wall run
 	if (bUseWallRun) {
 		HoldJumpButtonElapsedTime += DeltaTime;
@@ -70,6 +96,8 @@ float UShooterCharacterMovement::GetMaxSpeed() const
 
 void UShooterCharacterMovement::OnMovementUpdated(float DeltaSeconds, const FVector & OldLocation, const FVector & OldVelocity) {
 	
+	SimulateJetpackFuel(DeltaSeconds);
+
 	if (bUseTeleport) {
 		SetMovementMode(EMovementMode::MOVE_Custom, ECustomMovementMode::CUSTOM_Teleport);
 	}
@@ -78,7 +106,7 @@ void UShooterCharacterMovement::OnMovementUpdated(float DeltaSeconds, const FVec
 		SetMovementMode(EMovementMode::MOVE_Custom, ECustomMovementMode::CUSTOM_Jetpack);
 	}
 
-	if (HoldJumpButtonElapsedTime >= HoldJumpButtonTime) {
+	if (HoldJumpButtonElapsedTime >= HoldJumpButtonTime && !IsCustomMovementMode(ECustomMovementMode::CUSTOM_WallRun)) {
 		SetMovementMode(EMovementMode::MOVE_Custom, ECustomMovementMode::CUSTOM_WallRun);
 	}
 
@@ -104,26 +132,39 @@ void UShooterCharacterMovement::PhysCustom(float deltaTime, int32 Iterations) {
 	}
 }
 
-FHitResult UShooterCharacterMovement::IsTouchingAround() {
+const FHitResult& UShooterCharacterMovement::IsTouchingAround() {
 	
 	FVector Center = GetOwner()->GetActorLocation();
-	
-	FCollisionQueryParams Params;
-	// Ignore the character's pawn
-	Params.AddIgnoredActor(GetOwner());
+
+	// Walls don't move, keep the last contact while running along it
+	if (bHasCachedWallHit && CachedWallHit.bBlockingHit && CachedWallHit.Component.IsValid() &&
+		FVector::DistSquared(Center, CachedWallProbeLocation) < FMath::Square(WallContactRecheckDistance)) {
+		INC_DWORD_STAT(STAT_WallRunProbeCacheHits);
+		return CachedWallHit;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_WallRunProbe);
+	INC_DWORD_STAT(STAT_WallRunProbeSweeps);
 
 	FCollisionShape CollShape = FCollisionShape::MakeSphere(DistanceFromWall);
 
-	FHitResult Hit;
+	CachedWallHit = FHitResult();
+	CachedWallProbeLocation = Center;
+	bHasCachedWallHit = true;
+
 	//DrawDebugSphere(GetWorld(), Center, DistanceFromWall, 12, FColor::Orange, false, 4.0f);
-	bool bHit = GetWorld()->SweepSingleByChannel(Hit, Center, Center, FQuat::Identity, ECC_Pawn, CollShape, Params);
+	bool bHit = GetWorld()->SweepSingleByChannel(CachedWallHit, Center, Center, FQuat::Identity, COLLISION_WALLRUN, CollShape, WallProbeParams);
 	
 	if (bHit) {
-		FVector LinePoint2 = Hit.ImpactPoint + Hit.ImpactNormal * 2000.0f;
-		CheckHitSide(Hit.ImpactPoint, LinePoint2, Center);
+		FVector LinePoint2 = CachedWallHit.ImpactPoint + CachedWallHit.ImpactNormal * 2000.0f;
+		CheckHitSide(CachedWallHit.ImpactPoint, LinePoint2, Center);
 	}
 
-	return Hit;
+	return CachedWallHit;
+}
+
+void UShooterCharacterMovement::ResetWallContact() {
+	bHasCachedWallHit = false;
 }
 
 void UShooterCharacterMovement::EnableAbility() {
@@ -153,12 +194,8 @@ void UShooterCharacterMovement::PhysTeleport(float deltaTime, int32 Iterations)
 }
 
 void UShooterCharacterMovement::SetTeleport(bool useRequest) {
-	
-	if (!GetOwner()->HasAuthority() && GetPawnOwner()->IsLocallyControlled()) {
-		ServerTeleport(useRequest);
-	} else {
-		ExecTeleport(useRequest);
-	}
+	/** Predicted locally, the server gets the request with the next move (see UpdateFromCompressedFlags) */
+	ExecTeleport(useRequest);
 }
 
 void UShooterCharacterMovement::ExecTeleport(bool useRequest) {
@@ -168,15 +205,6 @@ void UShooterCharacterMovement::ExecTeleport(bool useRequest) {
 	bCanUseAbility = !useRequest;
 }
 
-bool UShooterCharacterMovement::ServerTeleport_Validate(bool useRequest) {
-	return true;
-}
-
-void UShooterCharacterMovement::ServerTeleport_Implementation(bool useRequest) {
-	if (bCanUseAbility) {
-		ExecTeleport(useRequest);
-	}
-}
 
 
 //////////////////////////////////////////////////////////////////////////
@@ -186,33 +214,148 @@ void UShooterCharacterMovement::PhysJetpack(float deltaTime, int32 Iterations) {
 	
 	float JetDir = GetGravityZ() * -1; // Get gravity direction * -1  FMath::Sign(GetGravityZ())
 		
-	float FuelConsumed = JetpackFuelConsume * (deltaTime / JetpackTimeConsume);
-	ActualFuel = FMath::Clamp(ActualFuel - FuelConsumed, 0.0f, JetpackFuel);
-	if (ActualFuel <= 0.0f) {
-		bFuelOver = true;
-		bUseJetpack = false;
-		bFlyingFirstTime = true;
-		SetMovementMode(EMovementMode::MOVE_Falling);
-	}
-
+	/** Fuel is consumed by SimulateJetpackFuel() */
 	if (bFlyingFirstTime) {
 		ShooterCharacterOwner->PlayEfx(Efx_Jetpack);
 		bFlyingFirstTime = false;
 	}
 	
 	JetpackElapsedTime += deltaTime * JetDir;
-	float CurveValue = JetpackCurve->GetFloatValue(JetpackElapsedTime); // Evaluate curve
+	float CurveValue = EvaluateJetpackCurve(JetpackElapsedTime); // Evaluate curve
 	Velocity.Z = CurveValue * MaxJetpackSpeed * deltaTime;
 
 	PhysFalling(deltaTime, Iterations); // Use the falling physics	
 }
 
-void UShooterCharacterMovement::SetJetpack(bool useRequest) {
-	if (!GetOwner()->HasAuthority() && GetPawnOwner()->IsLocallyControlled()) {
-		ServerJetpack(useRequest);
-	} else {
-		ExecJetpack(useRequest);
+void UShooterCharacterMovement::BuildJetpackCurveTable() {
+	JetpackCurveTable.Reset();
+	if (JetpackCurve == nullptr) {
+		return;
+	}
+
+	JetpackCurve->GetTimeRange(JetpackCurveMinTime, JetpackCurveMaxTime);
+	JetpackCurveTable.SetNumUninitialized(JetpackCurveTableSize);
+	for (int32 i = 0; i < JetpackCurveTableSize; i++) {
+		const float Time = FMath::Lerp(JetpackCurveMinTime, JetpackCurveMaxTime, (float)i / (JetpackCurveTableSize - 1));
+		JetpackCurveTable[i] = JetpackCurve->GetFloatValue(Time);
+	}
+}
+
+float UShooterCharacterMovement::EvaluateJetpackCurve(float Time) const {
+	if (JetpackCurveTable.Num() == 0) {
+		return 1.0f;
+	}
+
+	const float Range = JetpackCurveMaxTime - JetpackCurveMinTime;
+	if (Range <= KINDA_SMALL_NUMBER) {
+		return JetpackCurveTable[0];
+	}
+
+	/** Constant outside the curve range, like the curve's default extrapolation */
+	const float Position = FMath::Clamp((Time - JetpackCurveMinTime) / Range, 0.0f, 1.0f) * (JetpackCurveTable.Num() - 1);
+	const int32 Index = FMath::Min(FMath::FloorToInt(Position), JetpackCurveTable.Num() - 2);
+	return FMath::Lerp(JetpackCurveTable[Index], JetpackCurveTable[Index + 1], Position - Index);
+}
+
+uint8 UShooterCharacterMovement::QuantizeFuel(float Fuel) const {
+	return JetpackFuel > 0.0f ? (uint8)FMath::Clamp(FMath::RoundToInt(Fuel / JetpackFuel * 255.0f), 0, 255) : 0;
+}
+
+void UShooterCharacterMovement::SimulateJetpackFuel(float DeltaSeconds) {
+	FuelStepRemainder += DeltaSeconds;
+	while (FuelStepRemainder >= JetpackFuelStepTime) {
+		FuelStepRemainder -= JetpackFuelStepTime;
+
+		if (bUseJetpack) {
+			float FuelConsumed = JetpackFuelConsume * (JetpackFuelStepTime / JetpackTimeConsume);
+			ActualFuel = FMath::Clamp(ActualFuel - FuelConsumed, 0.0f, JetpackFuel);
+			if (ActualFuel <= 0.0f) {
+				bFuelOver = true;
+				bUseJetpack = false;
+				bFlyingFirstTime = true;
+				if (IsCustomMovementMode(ECustomMovementMode::CUSTOM_Jetpack)) {
+					SetMovementMode(EMovementMode::MOVE_Falling);
+				}
+				RequestFuelCorrection();
+			}
+		} else {
+			float FuelRecovered = JetpackFuelRecover * (JetpackFuelStepTime * JetpackTimeRecover);
+			ActualFuel = FMath::Clamp(ActualFuel + FuelRecovered, 0.0f, JetpackFuel);
+
+			if (ActualFuel == JetpackFuel) {
+				if (bFuelOver) {
+					bFuelOver = false;
+					RequestFuelCorrection();
+				}
+			}
+		}
+	}
+
+	const ENetRole Role = CharacterOwner ? CharacterOwner->GetLocalRole() : ROLE_None;
+	if (Role == ROLE_Authority && bPendingFuelCorrection) {
+		/** Only remote clients get corrections, CurrentClientTimeStamp is the move just simulated */
+		bPendingFuelCorrection = false;
+		const bool bRemoteClient = CharacterOwner->GetRemoteRole() == ROLE_AutonomousProxy && !CharacterOwner->IsLocallyControlled();
+		if (bRemoteClient) {
+			FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character();
+			LastFuelCorrectionTime = GetWorld()->GetTimeSeconds();
+			ClientAdjustJetpackFuel(ServerData->CurrentClientTimeStamp, QuantizeFuel(ActualFuel), bFuelOver);
+		}
+	} else if (Role == ROLE_AutonomousProxy && !bClientUpdating) {
+		FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+		if (ClientData) {
+			const FFuelHistoryEntry Entry = { ClientData->CurrentTimeStamp, ActualFuel };
+			if (FuelHistory.Num() < FuelHistorySize) {
+				FuelHistory.Add(Entry);
+			} else {
+				FuelHistory[FuelHistoryHead] = Entry;
+				FuelHistoryHead = (FuelHistoryHead + 1) % FuelHistorySize;
+			}
+		}
+	}
+}
+
+void UShooterCharacterMovement::RequestFuelCorrection() {
+	/** Called on clients too while simulating, only the server sends */
+	if (CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_Authority) {
+		bPendingFuelCorrection = true;
+	}
+}
+
+void UShooterCharacterMovement::ClientAdjustJetpackFuel_Implementation(float TimeStamp, uint8 QuantizedFuel, bool bServerFuelOver) {
+	const float ServerFuel = QuantizedFuel / 255.0f * JetpackFuel;
+
+	/** Compare with what this client had after the same move and only apply the difference,
+	    so moves simulated since then are kept */
+	float ClientFuelAtTimeStamp = ActualFuel;
+	for (const FFuelHistoryEntry& Entry : FuelHistory) {
+		if (Entry.TimeStamp == TimeStamp) {
+			ClientFuelAtTimeStamp = Entry.Fuel;
+			break;
+		}
+	}
+
+	if (FMath::Abs((int32)QuantizeFuel(ClientFuelAtTimeStamp) - (int32)QuantizedFuel) > FuelCorrectionTolerance) {
+		const float FuelError = ServerFuel - ClientFuelAtTimeStamp;
+		ActualFuel = FMath::Clamp(ActualFuel + FuelError, 0.0f, JetpackFuel);
+
+		/** Moves that are not acknowledged yet could be replayed, keep them in line with the correction */
+		FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+		for (FSavedMovePtr& SavedMove : ClientData->SavedMoves) {
+			FSavedMove_ShooterCharacter* ShooterMove = static_cast<FSavedMove_ShooterCharacter*>(SavedMove.Get());
+			ShooterMove->savedActualFuel = FMath::Clamp(ShooterMove->savedActualFuel + FuelError, 0.0f, JetpackFuel);
+		}
+	}
+
+	if (bServerFuelOver && bUseJetpack) {
+		ExecJetpack(false);
 	}
+	bFuelOver = bServerFuelOver;
+}
+
+void UShooterCharacterMovement::SetJetpack(bool useRequest) {
+	/** Predicted locally, the server gets the request with the next move (see UpdateFromCompressedFlags) */
+	ExecJetpack(useRequest);
 }
 
 void UShooterCharacterMovement::ExecJetpack(bool useRequest) {
@@ -233,30 +376,6 @@ void UShooterCharacterMovement::ExecJetpack(bool useRequest) {
 	}
 }
 
-bool UShooterCharacterMovement::ServerJetpack_Validate(bool useRequest) {
-	return true;
-}
-
-void UShooterCharacterMovement::ServerJetpack_Implementation(bool useRequest) {
-	if (bCanUseAbility) {
-		ExecJetpack(useRequest);
-	} else if(!useRequest) { // stop the jetpack emission
-		ExecJetpack(useRequest);
-	}
-}
-
-void UShooterCharacterMovement::RecoverJetpackFuel(float DeltaTime) {
-	if (!bUseJetpack) {
-		float FuelRecovered = JetpackFuelRecover * (DeltaTime * JetpackTimeRecover);
-		ActualFuel = FMath::Clamp(ActualFuel + FuelRecovered, 0.0f, JetpackFuel);
-
-		if (ActualFuel == JetpackFuel) {
-			if (bFuelOver) {
-				bFuelOver = false;
-			}
-		}
-	}
-}
 
 float UShooterCharacterMovement::RetrieveActualFuel() {
 
@@ -286,6 +405,7 @@ void UShooterCharacterMovement::PhysWallRun(float deltaTime, int32 Iterations) {
 	}
 	
 	// Here interrupt the wall run
+	ResetWallContact();
 	bUseWallRun = false;
 	WallRunElapsedTime = 0.0f;
 	HoldJumpButtonElapsedTime = 0.0f;
@@ -302,14 +422,12 @@ void UShooterCharacterMovement::PhysWallRun(float deltaTime, int32 Iterations) {
 }
 
 void UShooterCharacterMovement::SetWallRun(bool useRequest) {
-	if (!GetOwner()->HasAuthority() && GetPawnOwner()->IsLocallyControlled()) {
-		ServerWallRun(useRequest);
-	} else {
-		ExecWallRun(useRequest);
-	}
+	/** Predicted locally, the server gets the request with the next move (see UpdateFromCompressedFlags) */
+	ExecWallRun(useRequest);
 }
 
 void UShooterCharacterMovement::ExecWallRun(bool useRequest) {
+	ResetWallContact();
 	bUseWallRun = useRequest;
 	bCanUseAbility = !useRequest;
 
@@ -320,16 +438,54 @@ void UShooterCharacterMovement::ExecWallRun(bool useRequest) {
 	}
 }
 
-bool UShooterCharacterMovement::ServerWallRun_Validate(bool useRequest) {
-	return true;
+//////////////////////////////////////////////////////////////////////////
+// Network area
+void UShooterCharacterMovement::UpdateFromCompressedFlags(uint8 Flags) {
+	Super::UpdateFromCompressedFlags(Flags);
+
+	/** The flags are sent with every move, only react when an input changes so the 
+	    server doesn't reset its own ability state (e.g. SetMovementMode in ExecJetpack) */
+	const bool bWantsTeleport = (Flags & SHOOTERFLAG_Teleport) != 0;
+	if (bWantsTeleport && !bUseTeleport && bCanUseAbility) {
+		ExecTeleport(true);
+	}
+
+	const bool bWantsJetpack = (Flags & SHOOTERFLAG_Jetpack) != 0;
+	if (bWantsJetpack != bUseJetpack) {
+		if (bCanUseAbility || !bWantsJetpack) { // stopping the jetpack emission is always allowed
+			ExecJetpack(bWantsJetpack);
+		}
+
+		/** The client still flies on fuel the server doesn't have, or the jetpack just started or stopped */
+		if (LastFuelCorrectionTime < 0.0f || GetWorld()->GetTimeSeconds() - LastFuelCorrectionTime > 0.1f) {
+			RequestFuelCorrection();
+		}
+	}
+
+	const bool bWantsWallRun = (Flags & SHOOTERFLAG_WallRun) != 0;
+	if (bWantsWallRun != bUseWallRun) {
+		ExecWallRun(bWantsWallRun);
+	}
 }
 
-void UShooterCharacterMovement::ServerWallRun_Implementation(bool useRequest) {
-	ExecWallRun(useRequest);
+void UShooterCharacterMovement::OnClientCorrectionReceived(FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode) {
+	Super::OnClientCorrectionReceived(ClientData, TimeStamp, NewLocation, NewVelocity, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode);
+
+	NumCorrections++;
+	INC_DWORD_STAT(STAT_MovementCorrections);
+}
+
+bool UShooterCharacterMovement::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) {
+	const bool bNeedsCorrection = Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientWorldLocation, RelativeClientLocation, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+	if (bNeedsCorrection) {
+		RequestFuelCorrection();
+		NumCorrections++;
+		INC_DWORD_STAT(STAT_MovementCorrections);
+	}
+
+	return bNeedsCorrection;
 }
 
-//////////////////////////////////////////////////////////////////////////
-// Network area
 FNetworkPredictionData_Client* UShooterCharacterMovement::GetPredictionData_Client() const {
 	check(PawnOwner != NULL);
 
@@ -358,6 +514,10 @@ void FSavedMove_ShooterCharacter::Clear() {
 	savedUseTeleport = false;
 	savedUseJetpack = false;
 	savedUseWallRun = false;
+	savedActualFuel = 0.0f;
+	savedFuelStepRemainder = 0.0f;
+	savedJetpackElapsedTime = 0.0f;
+	savedFuelOver = false;
 }
 
 void FSavedMove_ShooterCharacter::SetMoveFor(ACharacter * Character, float InDeltaTime, FVector const & NewAccel, FNetworkPredictionData_Client_Character & ClientData) {
@@ -367,16 +527,72 @@ void FSavedMove_ShooterCharacter::SetMoveFor(ACharacter * Character, float InDel
 		savedUseTeleport = CharacterMovement->bUseTeleport;
 		savedUseJetpack = CharacterMovement->bUseJetpack;
 		savedUseWallRun = CharacterMovement->bUseWallRun;
+		savedActualFuel = CharacterMovement->ActualFuel;
+		savedFuelStepRemainder = CharacterMovement->FuelStepRemainder;
+		savedJetpackElapsedTime = CharacterMovement->JetpackElapsedTime;
+		savedFuelOver = CharacterMovement->bFuelOver;
 	}
 }
 
 void FSavedMove_ShooterCharacter::PrepMoveFor(ACharacter * Character) {
 	Super::PrepMoveFor(Character);
 
+	/** Restore the inputs as they were when the move was made. Going through the Exec functions 
+	    here would change the movement mode and cool downs in the middle of a replay */
 	UShooterCharacterMovement* CharacterMovement = Cast<UShooterCharacterMovement>(Character->GetCharacterMovement());
 	if (CharacterMovement) {
-		CharacterMovement->ExecTeleport(savedUseTeleport);
-		CharacterMovement->ExecJetpack(savedUseJetpack);
-		CharacterMovement->ExecJetpack(savedUseWallRun);
+		CharacterMovement->bUseTeleport = savedUseTeleport;
+		CharacterMovement->bUseJetpack = savedUseJetpack;
+		CharacterMovement->bUseWallRun = savedUseWallRun;
+		CharacterMovement->ActualFuel = savedActualFuel;
+		CharacterMovement->FuelStepRemainder = savedFuelStepRemainder;
+		CharacterMovement->JetpackElapsedTime = savedJetpackElapsedTime;
+		CharacterMovement->bFuelOver = savedFuelOver;
+	}
+}
+
+uint8 FSavedMove_ShooterCharacter::GetCompressedFlags() const {
+	uint8 Result = Super::GetCompressedFlags();
+
+	if (savedUseTeleport) {
+		Result |= SHOOTERFLAG_Teleport;
+	}
+	if (savedUseJetpack) {
+		Result |= SHOOTERFLAG_Jetpack;
+	}
+	if (savedUseWallRun) {
+		Result |= SHOOTERFLAG_WallRun;
+	}
+
+	return Result;
+}
+
+bool FSavedMove_ShooterCharacter::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const {
+	const FSavedMove_ShooterCharacter* NewShooterMove = static_cast<const FSavedMove_ShooterCharacter*>(NewMove.Get());
+	if (savedUseTeleport != NewShooterMove->savedUseTeleport ||
+		savedUseJetpack != NewShooterMove->savedUseJetpack ||
+		savedUseWallRun != NewShooterMove->savedUseWallRun) {
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_ShooterCharacter::CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation) {
+	Super::CombineWith(OldMove, InCharacter, PC, OldStartLocation);
+
+	/** The combined move starts where the pending move started and covers its time again */
+	const FSavedMove_ShooterCharacter* OldShooterMove = static_cast<const FSavedMove_ShooterCharacter*>(OldMove);
+	savedActualFuel = OldShooterMove->savedActualFuel;
+	savedFuelStepRemainder = OldShooterMove->savedFuelStepRemainder;
+	savedJetpackElapsedTime = OldShooterMove->savedJetpackElapsedTime;
+	savedFuelOver = OldShooterMove->savedFuelOver;
+
+	UShooterCharacterMovement* CharacterMovement = Cast<UShooterCharacterMovement>(InCharacter->GetCharacterMovement());
+	if (CharacterMovement) {
+		CharacterMovement->ActualFuel = savedActualFuel;
+		CharacterMovement->FuelStepRemainder = savedFuelStepRemainder;
+		CharacterMovement->JetpackElapsedTime = savedJetpackElapsedTime;
+		CharacterMovement->bFuelOver = savedFuelOver;
 	}
 }
\ No newline at end of file
@@ -77,4 +77,12 @@ void UShooterCheatManager::SpawnBot()
 		AShooterAIController* ShooterAIController = MyGame->CreateBot(CheatBotNum++);
 		MyGame->RestartPlayer(ShooterAIController);		
 	}
+}
+
+void UShooterCheatManager::SpawnBots(int32 Count)
+{
+	for (int32 i = 0; i < Count; ++i)
+	{
+		SpawnBot();
+	}
 }
\ No newline at end of file
@@ -20,7 +20,6 @@
 #include "ShooterLeaderboards.h"
 #include "ShooterGameViewportClient.h"
 #include "Sound/SoundNodeLocalPlayer.h"
-#include "AudioThread.h"
 #include "OnlineSubsystemUtils.h"
 
 #define  ACH_FRAG_SOMEONE	TEXT("ACH_FRAG_SOMEONE")
@@ -149,12 +148,7 @@ void AShooterPlayerController::TickActor(float DeltaTime, enum ELevelTick TickTy
 		}
 	}
 
-	const bool bLocallyControlled = IsLocalController();
-	const uint32 UniqueID = GetUniqueID();
-	FAudioThread::RunCommandOnAudioThread([UniqueID, bLocallyControlled]()
-	{
-		USoundNodeLocalPlayer::GetLocallyControlledActorCache().Add(UniqueID, bLocallyControlled);
-	});
+	USoundNodeLocalPlayer::SetLocallyControlled(GetUniqueID(), IsLocalController());
 };
 
 void AShooterPlayerController::BeginDestroy()
@@ -167,11 +161,7 @@ void AShooterPlayerController::BeginDestroy()
 
 	if (!GExitPurge)
 	{
-		const uint32 UniqueID = GetUniqueID();
-		FAudioThread::RunCommandOnAudioThread([UniqueID]()
-		{
-			USoundNodeLocalPlayer::GetLocallyControlledActorCache().Remove(UniqueID);
-		});
+		USoundNodeLocalPlayer::RemoveLocallyControlled(GetUniqueID());
 	}
 }
 
@@ -1330,6 +1320,27 @@ void AShooterPlayerController::UpdateLeaderboardsOnGameEnd()
 	}
 }
 
+/** stat of a player from the game state's scoreboard stats, falling back to the player state if it has no row yet */
+static int32 GetMatchStat(const AShooterPlayerState* ShooterPlayerState, EShooterScoreboardStat::Type Stat)
+{
+	const AShooterGameState* const GameState = ShooterPlayerState->GetWorld()->GetGameState<AShooterGameState>();
+	const int32 Row = GameState ? GameState->GetScoreboardStats().FindRow(ShooterPlayerState) : INDEX_NONE;
+	if (Row != INDEX_NONE)
+	{
+		return GameState->GetScoreboardStats().GetStat(Row, Stat);
+	}
+
+	switch (Stat)
+	{
+		case EShooterScoreboardStat::Kills:			return ShooterPlayerState->GetKills();
+		case EShooterScoreboardStat::Deaths:		return ShooterPlayerState->GetDeaths();
+		case EShooterScoreboardStat::Score:			return FMath::TruncToInt(ShooterPlayerState->GetScore());
+		case EShooterScoreboardStat::BulletsFired:	return ShooterPlayerState->GetNumBulletsFired();
+		case EShooterScoreboardStat::RocketsFired:	return ShooterPlayerState->GetNumRocketsFired();
+		default:									return 0;
+	}
+}
+
 void AShooterPlayerController::UpdateStatsOnGameEnd(bool bIsWinner)
 {
 	const IOnlineStatsPtr Stats = Online::GetStatsInterface(GetWorld());
@@ -1345,8 +1356,8 @@ void AShooterPlayerController::UpdateStatsOnGameEnd(bool bIsWinner)
 			TArray<FOnlineStatsUserUpdatedStats> UpdatedUserStats;
 
 			FOnlineStatsUserUpdatedStats& UpdatedStats = UpdatedUserStats.Emplace_GetRef( UniqueId.GetUniqueNetId().ToSharedRef() );
-			UpdatedStats.Stats.Add( TEXT("Kills"), FOnlineStatUpdate( ShooterPlayerState->GetKills(), FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
-			UpdatedStats.Stats.Add( TEXT("Deaths"), FOnlineStatUpdate( ShooterPlayerState->GetDeaths(), FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
+			UpdatedStats.Stats.Add( TEXT("Kills"), FOnlineStatUpdate( GetMatchStat(ShooterPlayerState, EShooterScoreboardStat::Kills), FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
+			UpdatedStats.Stats.Add( TEXT("Deaths"), FOnlineStatUpdate( GetMatchStat(ShooterPlayerState, EShooterScoreboardStat::Deaths), FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
 			UpdatedStats.Stats.Add( TEXT("RoundsPlayed"), FOnlineStatUpdate( 1, FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
 			if (bIsWinner)
 			{
@@ -1368,7 +1379,12 @@ void AShooterPlayerController::UpdateSaveFileOnGameEnd(bool bIsWinner)
 		UShooterPersistentUser* const PersistentUser = GetPersistentUser();
 		if (PersistentUser)
 		{
-			PersistentUser->AddMatchResult(ShooterPlayerState->GetKills(), ShooterPlayerState->GetDeaths(), ShooterPlayerState->GetNumBulletsFired(), ShooterPlayerState->GetNumRocketsFired(), bIsWinner);
+			PersistentUser->AddMatchResult(
+				GetMatchStat(ShooterPlayerState, EShooterScoreboardStat::Kills),
+				GetMatchStat(ShooterPlayerState, EShooterScoreboardStat::Deaths),
+				GetMatchStat(ShooterPlayerState, EShooterScoreboardStat::BulletsFired),
+				GetMatchStat(ShooterPlayerState, EShooterScoreboardStat::RocketsFired),
+				bIsWinner);
 			PersistentUser->SaveIfDirty();
 		}
 	}
@@ -4,6 +4,8 @@
 #include "Online/ShooterPlayerState.h"
 #include "GameDelegates.h"
 #include "IPlatformFilePak.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
 
 #include "UObject/PackageReload.h"
 
@@ -58,7 +60,10 @@ static void WebServerDelegate(int32 UserIndex, const FString& Action, const FStr
 {
 	if (URL == TEXT("/index.html?scoreboard"))
 	{
-		FString ScoreboardStr = TEXT("{ \"scoreboard\" : [ ");
+		FString ScoreboardStr;
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&ScoreboardStr);
+		Writer->WriteObjectStart();
+		Writer->WriteArrayStart(TEXT("scoreboard"));
 
 		// you shouldn't normally use this method to get a UWorld as it won't always be correct in a PIE context.
 		// However, the PS4 companion app server will never run in the Editor.
@@ -73,24 +78,28 @@ static void WebServerDelegate(int32 UserIndex, const FString& Action, const FStr
 				{
 					// get the shoter game
 					AShooterGameState* const GameState = Player->PlayerController->GetWorld()->GetGameState<AShooterGameState>();
+					const FShooterScoreboardStats& Stats = GameState->GetScoreboardStats();
 
-
-					RankedPlayerMap Players;
-					GameState->GetRankedMap(0, Players);
-
-					bool bNeedsComma = false;
-					for (auto It = Players.CreateIterator(); It; ++It)
+					for (RankedPlayerMap::TConstIterator It(GameState->GetCachedRankedMap(0)); It; ++It)
 					{
-						if (bNeedsComma)
+						const AShooterPlayerState* PlayerState = It.Value().Get();
+						const int32 Row = Stats.FindRow(PlayerState);
+						if (Row == INDEX_NONE)
 						{
-							ScoreboardStr += TEXT(" ,");
+							continue;
 						}
-						ScoreboardStr += FString::Printf(TEXT(" { \"n\" : \"%s\" , \"k\" : \"%d\" , \"d\" : \"%d\" }"), *It.Value()->GetShortPlayerName(), It.Value()->GetKills(), It.Value()->GetDeaths());
-						bNeedsComma = true;
+
+						Writer->WriteObjectStart();
+						Writer->WriteValue(TEXT("n"), PlayerState->GetShortPlayerName());
+						Writer->WriteValue(TEXT("k"), FString::FromInt(Stats.GetStat(Row, EShooterScoreboardStat::Kills)));
+						Writer->WriteValue(TEXT("d"), FString::FromInt(Stats.GetStat(Row, EShooterScoreboardStat::Deaths)));
+						Writer->WriteObjectEnd();
 					}
 				}
 
-				ScoreboardStr += TEXT(" ] }");
+				Writer->WriteArrayEnd();
+				Writer->WriteObjectEnd();
+				Writer->Close();
 
 				Response.Add(TEXT("Content-Type"), TEXT("text/html; charset=utf-8"));
 				Response.Add(TEXT("Body"), ScoreboardStr);
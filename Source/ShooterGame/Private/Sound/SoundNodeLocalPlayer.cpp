@@ -6,7 +6,19 @@
 
 #define LOCTEXT_NAMESPACE "SoundNodeLocalPlayer"
 
-TMap<uint32, bool> USoundNodeLocalPlayer::LocallyControlledActorCache;
+TAtomic<uint64> USoundNodeLocalPlayer::LocallyControlledTable[USoundNodeLocalPlayer::LocallyControlledTableSize];
+
+namespace LocallyControlledTable
+{
+	// Slot layout: [63] in use, [33] live, [32] locally controlled, [31..0] actor id. 0 means the slot was never used.
+	static const uint64 InUseBit = 1ull << 63;
+	static const uint64 LiveBit = 1ull << 33;
+	static const uint64 LocalBit = 1ull << 32;
+
+	FORCEINLINE uint32 GetID(uint64 Slot) { return (uint32)(Slot & 0xFFFFFFFFull); }
+	FORCEINLINE uint64 MakeSlot(uint32 ActorID, bool bLive, bool bLocallyControlled) { return InUseBit | (bLive ? LiveBit : 0) | (bLocallyControlled ? LocalBit : 0) | (uint64)ActorID; }
+	FORCEINLINE uint32 GetHomeSlot(uint32 ActorID, uint32 TableSize) { return (ActorID * 2654435761u) & (TableSize - 1); }
+}
 
 USoundNodeLocalPlayer::USoundNodeLocalPlayer(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -14,11 +26,7 @@ USoundNodeLocalPlayer::USoundNodeLocalPlayer(const FObjectInitializer& ObjectIni
 
 void USoundNodeLocalPlayer::ParseNodes(FAudioDevice* AudioDevice, const UPTRINT NodeWaveInstanceHash, FActiveSound& ActiveSound, const FSoundParseParameters& ParseParams, TArray<FWaveInstance*>& WaveInstances)
 {
-	bool bLocallyControlled = false;
-	if (bool* LocallyControlledPtr = LocallyControlledActorCache.Find(ActiveSound.GetOwnerID()))
-	{
-		bLocallyControlled = *LocallyControlledPtr;
-	}
+	const bool bLocallyControlled = IsLocallyControlled(ActiveSound.GetOwnerID());
 
 	const int32 PlayIndex = bLocallyControlled ? 0 : 1;
 
@@ -28,6 +36,115 @@ void USoundNodeLocalPlayer::ParseNodes(FAudioDevice* AudioDevice, const UPTRINT
 	}
 }
 
+int32 USoundNodeLocalPlayer::FindLocallyControlledSlot(uint32 ActorID, int32* OutFreeSlot)
+{
+	static_assert((LocallyControlledTableSize & (LocallyControlledTableSize - 1)) == 0, "Table size must be a power of two");
+
+	if (OutFreeSlot)
+	{
+		*OutFreeSlot = INDEX_NONE;
+	}
+
+	uint32 Index = LocallyControlledTable::GetHomeSlot(ActorID, LocallyControlledTableSize);
+	for (uint32 Probe = 0; Probe < LocallyControlledMaxProbe; ++Probe, Index = (Index + 1) & (LocallyControlledTableSize - 1))
+	{
+		const uint64 Slot = LocallyControlledTable[Index].Load(EMemoryOrder::Relaxed);
+		if (Slot == 0)
+		{
+			// End of the probe chain
+			if (OutFreeSlot && *OutFreeSlot == INDEX_NONE)
+			{
+				*OutFreeSlot = Index;
+			}
+			return INDEX_NONE;
+		}
+
+		if (LocallyControlledTable::GetID(Slot) == ActorID)
+		{
+			return Index;
+		}
+
+		if (OutFreeSlot && *OutFreeSlot == INDEX_NONE && (Slot & LocallyControlledTable::LiveBit) == 0)
+		{
+			*OutFreeSlot = Index;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+void USoundNodeLocalPlayer::SetLocallyControlled(uint32 ActorID, bool bLocallyControlled)
+{
+	check(IsInGameThread());
+
+	int32 FreeSlot = INDEX_NONE;
+	int32 SlotIndex = FindLocallyControlledSlot(ActorID, &FreeSlot);
+	if (SlotIndex == INDEX_NONE)
+	{
+		if (!bLocallyControlled)
+		{
+			// Unknown actors already read as remote
+			return;
+		}
+
+		SlotIndex = FreeSlot;
+		if (SlotIndex == INDEX_NONE)
+		{
+			UE_LOG(LogShooter, Warning, TEXT("USoundNodeLocalPlayer: no free slot within %u probes, actor %u will play remote sounds."), LocallyControlledMaxProbe, ActorID);
+			return;
+		}
+	}
+
+	LocallyControlledTable[SlotIndex].Store(LocallyControlledTable::MakeSlot(ActorID, true, bLocallyControlled));
+}
+
+void USoundNodeLocalPlayer::RemoveLocallyControlled(uint32 ActorID)
+{
+	check(IsInGameThread());
+
+	const int32 SlotIndex = FindLocallyControlledSlot(ActorID, nullptr);
+	if (SlotIndex != INDEX_NONE)
+	{
+		LocallyControlledTable[SlotIndex].Store(LocallyControlledTable::MakeSlot(ActorID, false, false));
+		ReclaimTombstones(SlotIndex);
+	}
+}
+
+void USoundNodeLocalPlayer::ReclaimTombstones(int32 SlotIndex)
+{
+	const uint32 Mask = LocallyControlledTableSize - 1;
+
+	// A chain that doesn't go past the next slot can't hold any id beyond it, so readers stop at an empty slot here with the same result
+	if (LocallyControlledTable[(SlotIndex + 1) & Mask].Load(EMemoryOrder::Relaxed) != 0)
+	{
+		return;
+	}
+
+	uint32 Index = (uint32)SlotIndex;
+	for (uint32 Count = 0; Count < LocallyControlledTableSize; ++Count, Index = (Index - 1) & Mask)
+	{
+		const uint64 Slot = LocallyControlledTable[Index].Load(EMemoryOrder::Relaxed);
+		if (Slot == 0 || (Slot & LocallyControlledTable::LiveBit) != 0)
+		{
+			break;
+		}
+
+		LocallyControlledTable[Index].Store(0);
+	}
+}
+
+bool USoundNodeLocalPlayer::IsLocallyControlled(uint32 ActorID)
+{
+	const int32 SlotIndex = FindLocallyControlledSlot(ActorID, nullptr);
+	if (SlotIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const uint64 Slot = LocallyControlledTable[SlotIndex].Load();
+	return LocallyControlledTable::GetID(Slot) == ActorID && (Slot & LocallyControlledTable::LiveBit) && (Slot & LocallyControlledTable::LocalBit);
+}
+
 #if WITH_EDITOR
 FText USoundNodeLocalPlayer::GetInputPinName(int32 PinIndex) const
 {
@@ -422,9 +422,7 @@ void AShooterHUD::DrawMatchTimerAndPosition()
 					int32 NumTeams = 0;
 					for (int32 i=0; i < MyGameState->NumTeams; i++)
 					{
-						RankedPlayerMap PlayerStateMap;
-						MyGameState->GetRankedMap(i,PlayerStateMap);
-						if(PlayerStateMap.Num() > 0)
+						if(MyGameState->GetCachedRankedMap(i).Num() > 0)
 						{
 							NumTeams++;
 						}
@@ -433,8 +431,7 @@ void AShooterHUD::DrawMatchTimerAndPosition()
 				}
 				else // free for all
 				{
-					RankedPlayerMap PlayerStateMap;
-					MyGameState->GetRankedMap(0,PlayerStateMap);
+					const RankedPlayerMap& PlayerStateMap = MyGameState->GetCachedRankedMap(0);
 					const int32* MyRank = PlayerStateMap.FindKey(MyPlayerState);
 					int32 MyPos = MyRank ? *MyRank + 1 : 0;
 					Text = FString::Printf(TEXT("%d/%d"), MyPos, PlayerStateMap.Num());
@@ -483,9 +480,10 @@ void AShooterHUD::DrawKills()
 	Canvas->DrawItem( TextItem, KillsPosX + Offset * ScaleUI + KillsIcon.UL * 1.5f * ScaleUI,
 		KillsPosY + (KillsBg.VL * ScaleUI - SizeY * TextScale * ScaleUI) / 2 );
 
-	if (MyPlayerState)
+	const AShooterGameState* const MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	if (MyPlayerState && MyGameState)
 	{
-		Text = FString::FromInt(MyPlayerState->GetKills());
+		Text = FString::FromInt(MyGameState->GetScoreboardStats().GetPlayerStat(MyPlayerState, EShooterScoreboardStat::Kills));
 	}
 	else 
 	{
@@ -29,20 +29,21 @@ void SShooterScoreboardWidget::Construct(const FArguments& InArgs)
 
 	ScoreboardStartTime = FPlatformTime::Seconds();
 	MatchState = InArgs._MatchState.Get();
+	RankingVersion = 0;
 
 	UpdatePlayerStateMaps();
 	
 	Columns.Add(FColumnData(LOCTEXT("KillsColumn", "Kills"),
 		ScoreboardStyle->KillStatColor,
-		FOnGetPlayerStateAttribute::CreateSP(this, &SShooterScoreboardWidget::GetAttributeValue_Kills)));
+		EShooterScoreboardStat::Kills));
 
 	Columns.Add(FColumnData(LOCTEXT("DeathsColumn", "Deaths"),
 		ScoreboardStyle->DeathStatColor,
-		FOnGetPlayerStateAttribute::CreateSP(this, &SShooterScoreboardWidget::GetAttributeValue_Deaths)));
+		EShooterScoreboardStat::Deaths));
 
 	Columns.Add(FColumnData(LOCTEXT("ScoreColumn", "Score"),
 		ScoreboardStyle->ScoreStatColor,
-		FOnGetPlayerStateAttribute::CreateSP(this, &SShooterScoreboardWidget::GetAttributeValue_Score)));
+		EShooterScoreboardStat::Score));
 
 	TSharedPtr<SHorizontalBox> HeaderCols;
 
@@ -204,13 +205,20 @@ FText SShooterScoreboardWidget::GetMatchOutcomeText() const
 void SShooterScoreboardWidget::UpdateScoreboardGrid()
 {
 	ScoreboardData->ClearChildren();
+	TeamRowBoxes.Reset();
+	TeamRows.Reset();
+	TeamRowBoxes.AddDefaulted(PlayerStateMaps.Num());
+	TeamRows.AddDefaulted(PlayerStateMaps.Num());
+
 	for (uint8 TeamNum = 0; TeamNum < PlayerStateMaps.Num(); TeamNum++)
 	{
 		//Player rows from each team
 		ScoreboardData->AddSlot() .AutoHeight()
 			[
-				MakePlayerRows(TeamNum)
+				SAssignNew(TeamRowBoxes[TeamNum], SVerticalBox)
 			];
+		UpdatePlayerRows(TeamNum);
+
 		//If we have more than one team, we are playing team based game mode, add totals
 		if (PlayerStateMaps.Num() > 1 && PlayerStateMaps[TeamNum].Num() > 0)
 		{
@@ -285,30 +293,47 @@ void SShooterScoreboardWidget::UpdatePlayerStateMaps()
 		AShooterGameState* const GameState = PCOwner->GetWorld()->GetGameState<AShooterGameState>();
 		if (GameState)
 		{
-			bool bRequiresWidgetUpdate = false;
-			const int32 NumTeams = FMath::Max(GameState->NumTeams, 1);
-			LastTeamPlayerCount.Reset();
-			LastTeamPlayerCount.AddZeroed(PlayerStateMaps.Num());
-			for (int32 i = 0; i < PlayerStateMaps.Num(); i++)
+			// nobody scored, joined, left or changed team
+			if (GameState == RankedGameState.Get() && GameState->GetRankingVersion() == RankingVersion)
 			{
-				LastTeamPlayerCount[i] = PlayerStateMaps[i].Num();
+				return;
 			}
 
-			PlayerStateMaps.Reset();
-			PlayerStateMaps.AddZeroed(NumTeams);
-		
+			RankedGameState = GameState;
+			RankingVersion = GameState->GetRankingVersion();
+
+			const int32 NumTeams = FMath::Max(GameState->NumTeams, 1);
+			bool bRequiresGridUpdate = (PlayerStateMaps.Num() != NumTeams);
+			TArray<uint8, TInlineAllocator<4>> TeamsToUpdate;
+
+			PlayerStateMaps.SetNum(NumTeams);
 			for (int32 i = 0; i < NumTeams; i++)
 			{
-				GameState->GetRankedMap(i, PlayerStateMaps[i]);
+				const int32 LastPlayerCount = PlayerStateMaps[i].Num();
+				PlayerStateMaps[i] = GameState->GetCachedRankedMap(i);
 
-				if (LastTeamPlayerCount.Num() > 0 && PlayerStateMaps[i].Num() != LastTeamPlayerCount[i])
+				if (LastPlayerCount != PlayerStateMaps[i].Num())
 				{
-					bRequiresWidgetUpdate = true;
+					// team totals are only shown for teams with players
+					bRequiresGridUpdate |= (LastPlayerCount == 0 || PlayerStateMaps[i].Num() == 0);
+					TeamsToUpdate.Add(i);
 				}
 			}
-			if (bRequiresWidgetUpdate)
+
+			// not constructed yet on the first update
+			if (ScoreboardData.IsValid())
 			{
-				UpdateScoreboardGrid();
+				if (bRequiresGridUpdate)
+				{
+					UpdateScoreboardGrid();
+				}
+				else
+				{
+					for (uint8 TeamNum : TeamsToUpdate)
+					{
+						UpdatePlayerRows(TeamNum);
+					}
+				}
 			}
 		}
 	}
@@ -664,26 +689,20 @@ bool SShooterScoreboardWidget::IsOwnerPlayer(const FTeamPlayer& TeamPlayer) cons
 	return ( PCOwner.IsValid() && PCOwner->PlayerState && PCOwner->PlayerState == GetSortedPlayerState(TeamPlayer) );
 }
 
-FText SShooterScoreboardWidget::GetStat(FOnGetPlayerStateAttribute Getter, const FTeamPlayer TeamPlayer) const
+FText SShooterScoreboardWidget::GetStat(EShooterScoreboardStat::Type Stat, const FTeamPlayer TeamPlayer) const
 {
 	int32 StatTotal = 0;
-	if (TeamPlayer.PlayerId != SpecialPlayerIndex::All)
+	const AShooterGameState* const GameState = RankedGameState.Get();
+	if (GameState)
 	{
-		AShooterPlayerState* PlayerState = GetSortedPlayerState(TeamPlayer);
-		if (PlayerState)
+		const FShooterScoreboardStats& Stats = GameState->GetScoreboardStats();
+		if (TeamPlayer.PlayerId != SpecialPlayerIndex::All)
 		{
-			StatTotal = Getter.Execute(PlayerState);
+			StatTotal = Stats.GetPlayerStat(GetSortedPlayerState(TeamPlayer), Stat);
 		}
-	} 
-	else
-	{
-		for (RankedPlayerMap::TConstIterator PlayerIt(PlayerStateMaps[TeamPlayer.TeamNum]); PlayerIt; ++PlayerIt)
+		else
 		{
-			AShooterPlayerState* PlayerState = PlayerIt.Value().Get();
-			if (PlayerState)
-			{
-				StatTotal += Getter.Execute(PlayerState);
-			}
+			StatTotal = Stats.GetTeamTotal(TeamPlayer.TeamNum, Stat);
 		}
 	}
 
@@ -756,7 +775,7 @@ TSharedRef<SWidget> SShooterScoreboardWidget::MakeTotalsRow(uint8 TeamNum) const
 			.HAlign(HAlign_Center)
 			[
 				SNew(STextBlock)
-				.Text(this, &SShooterScoreboardWidget::GetStat, Columns.Last().AttributeGetter, FTeamPlayer(TeamNum, SpecialPlayerIndex::All))
+				.Text(this, &SShooterScoreboardWidget::GetStat, Columns.Last().Stat, FTeamPlayer(TeamNum, SpecialPlayerIndex::All))
 				.TextStyle(FShooterStyle::Get(), "ShooterGame.DefaultScoreboard.Row.HeaderTextStyle")
 			]
 		]
@@ -765,24 +784,40 @@ TSharedRef<SWidget> SShooterScoreboardWidget::MakeTotalsRow(uint8 TeamNum) const
 	return TotalsRow.ToSharedRef();
 }
 
-TSharedRef<SWidget> SShooterScoreboardWidget::MakePlayerRows(uint8 TeamNum) const
+void SShooterScoreboardWidget::UpdatePlayerRows(uint8 TeamNum)
 {
-	TSharedRef<SVerticalBox> PlayerRows = SNew(SVerticalBox);
+	const TSharedPtr<SVerticalBox>& PlayerRows = TeamRowBoxes[TeamNum];
+	TArray<TSharedPtr<SWidget>>& Rows = TeamRows[TeamNum];
+	const int32 NumPlayers = PlayerStateMaps[TeamNum].Num();
 
-	for (int32 PlayerIndex=0; PlayerIndex < PlayerStateMaps[TeamNum].Num(); PlayerIndex++ )
+	// rows are bound to a rank, only ranks that appeared or disappeared need widgets changed
+	for (int32 PlayerIndex = Rows.Num() - 1; PlayerIndex >= NumPlayers; PlayerIndex--)
+	{
+		if (Rows[PlayerIndex].IsValid())
+		{
+			PlayerRows->RemoveSlot(Rows[PlayerIndex].ToSharedRef());
+		}
+	}
+	if (Rows.Num() > NumPlayers)
+	{
+		Rows.SetNum(NumPlayers);
+	}
+
+	for (int32 PlayerIndex = Rows.Num(); PlayerIndex < NumPlayers; PlayerIndex++)
 	{
 		FTeamPlayer TeamPlayer(TeamNum, PlayerIndex);
 
+		TSharedPtr<SWidget> Row;
 		if (ShouldPlayerBeDisplayed(TeamPlayer))
 		{
+			Row = MakePlayerRow(TeamPlayer);
 			PlayerRows->AddSlot().AutoHeight()
 				[
-					MakePlayerRow(TeamPlayer)
+					Row.ToSharedRef()
 				];
 		}
+		Rows.Add(Row);
 	}
-
-	return PlayerRows;
 }
 
 TSharedRef<SWidget> SShooterScoreboardWidget::MakePlayerRow(const FTeamPlayer& TeamPlayer) const
@@ -838,7 +873,7 @@ TSharedRef<SWidget> SShooterScoreboardWidget::MakePlayerRow(const FTeamPlayer& T
 				.HAlign(HAlign_Center)
 				[
 					SNew(STextBlock)
-					.Text(this, &SShooterScoreboardWidget::GetStat, Columns[ColIdx].AttributeGetter, TeamPlayer)
+					.Text(this, &SShooterScoreboardWidget::GetStat, Columns[ColIdx].Stat, TeamPlayer)
 					.TextStyle(FShooterStyle::Get(), "ShooterGame.DefaultScoreboard.Row.StatTextStyle")
 					.ColorAndOpacity(this, &SShooterScoreboardWidget::GetColumnColor, TeamPlayer, ColIdx)
 				]
@@ -858,19 +893,4 @@ AShooterPlayerState* SShooterScoreboardWidget::GetSortedPlayerState(const FTeamP
 	return NULL;
 }
 
-int32 SShooterScoreboardWidget::GetAttributeValue_Kills(AShooterPlayerState* PlayerState) const
-{
-	return PlayerState->GetKills();
-}
-
-int32 SShooterScoreboardWidget::GetAttributeValue_Deaths(AShooterPlayerState* PlayerState) const
-{
-	return PlayerState->GetDeaths();
-}
-
-int32 SShooterScoreboardWidget::GetAttributeValue_Score(AShooterPlayerState* PlayerState) const
-{
-	return FMath::TruncToInt(PlayerState->Score);
-}
-
 #undef LOCTEXT_NAMESPACE
@@ -4,8 +4,7 @@
 
 #include "SlateBasics.h"
 #include "SlateExtras.h"
-
-DECLARE_DELEGATE_RetVal_OneParam(int32, FOnGetPlayerStateAttribute, AShooterPlayerState*);
+#include "Online/ShooterScoreboardStats.h"
 
 namespace SpecialPlayerIndex
 {
@@ -20,19 +19,20 @@ struct FColumnData
 	/** Column color */
 	FSlateColor Color;
 
-	/** Stat value getter delegate */
-	FOnGetPlayerStateAttribute AttributeGetter;
+	/** Stat shown in the column */
+	EShooterScoreboardStat::Type Stat;
 
 	/** defaults */
 	FColumnData()
+		: Stat(EShooterScoreboardStat::Score)
 	{
 		Color = FLinearColor::White;
 	}
 
-	FColumnData(FText InName, FSlateColor InColor, FOnGetPlayerStateAttribute InAtrGetter)
+	FColumnData(FText InName, FSlateColor InColor, EShooterScoreboardStat::Type InStat)
 		: Name(InName)
 		, Color(InColor)
-		, AttributeGetter(InAtrGetter)
+		, Stat(InStat)
 	{
 	}
 };
@@ -111,18 +111,15 @@ protected:
 	/** makes total row widget */
 	TSharedRef<SWidget> MakeTotalsRow(uint8 TeamNum) const;
 
-	/** makes player rows */
-	TSharedRef<SWidget> MakePlayerRows(uint8 TeamNum) const;
+	/** adds or removes player rows of a team to match its player count, existing rows follow their rank */
+	void UpdatePlayerRows(uint8 TeamNum);
 
 	/** makes player row */
 	TSharedRef<SWidget> MakePlayerRow(const FTeamPlayer& TeamPlayer) const;
 
-	/** updates PlayerState maps to display accurate scores */
+	/** updates PlayerState maps when the game state's ranking changed */
 	void UpdatePlayerStateMaps();
 
-	/** gets ranked map for specific team */
-	void GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const;
-
 	/** gets PlayerState for specific team and player */
 	AShooterPlayerState* GetSortedPlayerState(const FTeamPlayer& TeamPlayer) const;
 
@@ -151,7 +148,7 @@ protected:
 	bool IsOwnerPlayer(const FTeamPlayer& TeamPlayer) const;
 
 	/** get specific stat for team number and optionally player */
-	FText GetStat(FOnGetPlayerStateAttribute Getter, const FTeamPlayer TeamPlayer) const;
+	FText GetStat(EShooterScoreboardStat::Type Stat, const FTeamPlayer TeamPlayer) const;
 
 	/** linear interpolated score for match outcome animation */
 	int32 LerpForCountup(int32 ScoreValue) const;
@@ -162,15 +159,6 @@ protected:
 	/** Get text for match-restart notification. */
 	FText GetMatchRestartText() const;
 
-	/** get attribute value for kills */
-	int32 GetAttributeValue_Kills(class AShooterPlayerState* PlayerState) const;
-
-	/** get attribute value for deaths */
-	int32 GetAttributeValue_Deaths(class AShooterPlayerState* PlayerState) const;
-
-	/** get attribute value for score */
-	int32 GetAttributeValue_Score(class AShooterPlayerState* PlayerState) const;
-
 	/** triggers a sound effect to play */
 	void PlaySound(const FSlateSound& SoundToPlay) const;
 
@@ -219,11 +207,20 @@ protected:
 	/** the player currently selected in the scoreboard */
 	FTeamPlayer SelectedPlayer;
 
-	/** the Ranked PlayerState map...cleared every frame */
+	/** the Ranked PlayerState map, copied from the game state when its ranking changes */
 	TArray<RankedPlayerMap> PlayerStateMaps;
 
-	/** player count in each team in the last tick */
-	TArray<int32> LastTeamPlayerCount;
+	/** game state the maps were copied from */
+	TWeakObjectPtr<AShooterGameState> RankedGameState;
+
+	/** ranking version the maps were copied at */
+	uint32 RankingVersion;
+
+	/** box holding the player rows of each team */
+	TArray<TSharedPtr<SVerticalBox>> TeamRowBoxes;
+
+	/** row of each rank in each team, invalid for players not displayed */
+	TArray<TArray<TSharedPtr<SWidget>>> TeamRows;
 
 	/** holds talking player data */
 	TArray<TPair<TSharedRef<const FUniqueNetId>, bool>> PlayersTalkingThisFrame;
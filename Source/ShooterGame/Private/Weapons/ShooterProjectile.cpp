@@ -4,6 +4,11 @@
 #include "Weapons/ShooterProjectile.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Effects/ShooterExplosionEffect.h"
+#include "Weapons/ShooterProjectileManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Activate"), STAT_ProjectileActivate, STATGROUP_ShooterGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Reused"), STAT_ProjectilesReused, STATGROUP_ShooterGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Destroyed"), STAT_ProjectilesDestroyed, STATGROUP_ShooterGame);
 
 AShooterProjectile::AShooterProjectile(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -37,6 +42,11 @@ AShooterProjectile::AShooterProjectile(const FObjectInitializer& ObjectInitializ
 	SetRemoteRoleForBackwardsCompat(ROLE_SimulatedProxy);
 	bReplicates = true;
 	SetReplicatingMovement(true);
+
+	bPooled = false;
+	PoolActivation = 0;
+	ExplodedLocation = FVector::ZeroVector;
+	ExplodedNormal = FVector::ZeroVector;
 }
 
 void AShooterProjectile::PostInitializeComponents()
@@ -55,6 +65,194 @@ void AShooterProjectile::PostInitializeComponents()
 	MyController = GetInstigatorController();
 }
 
+void AShooterProjectile::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		TryStartBatchedFlight();
+	}
+}
+
+void AShooterProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// destroyed outside the manager, e.g. when the channel closes or the level is torn down
+	AShooterProjectileManager* Manager = AShooterProjectileManager::Find(GetWorld());
+	if (Manager)
+	{
+		Manager->RemoveProjectile(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterProjectile::TryStartBatchedFlight()
+{
+	// the manager only moves in straight lines
+	if (!AShooterProjectileManager::IsEnabled() || MovementComp->ProjectileGravityScale != 0.0f ||
+		MovementComp->bShouldBounce || MovementComp->bIsHomingProjectile || MovementComp->Velocity.IsNearlyZero())
+	{
+		Launch = FShooterProjectileLaunch();
+		SetReplicatingMovement(true);
+		return;
+	}
+
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+
+	Launch.Origin = GetActorLocation();
+	Launch.Direction = MovementComp->Velocity.GetSafeNormal();
+	Launch.Speed = MovementComp->Velocity.Size();
+	Launch.ServerLaunchTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+	// clients extrapolate from the launch, movement doesn't have to be replicated
+	SetReplicatingMovement(false);
+	MovementComp->SetComponentTickEnabled(false);
+
+	AShooterProjectileManager::Get(GetWorld())->AddProjectile(this, GetActorLocation(), MovementComp->Velocity, CollisionComp->GetScaledSphereRadius());
+}
+
+void AShooterProjectile::OnRep_Launch()
+{
+	if (IsBatched() && !bExploded)
+	{
+		MovementComp->SetComponentTickEnabled(false);
+
+		const AGameStateBase* GameState = GetWorld()->GetGameState();
+		const float FlightTime = GameState ? FMath::Max(0.0f, GameState->GetServerWorldTimeSeconds() - Launch.ServerLaunchTime) : 0.0f;
+		const FVector LaunchVelocity = Launch.Direction * Launch.Speed;
+
+		SetActorRotation(Launch.Direction.Rotation());
+		AShooterProjectileManager::Get(GetWorld())->AddProjectile(this, Launch.Origin + LaunchVelocity * FlightTime, LaunchVelocity, CollisionComp->GetScaledSphereRadius());
+	}
+	else
+	{
+		// pooled projectiles are reset to an empty launch when they go back to the pool
+		AShooterProjectileManager* Manager = AShooterProjectileManager::Find(GetWorld());
+		if (Manager)
+		{
+			Manager->RemoveProjectile(this);
+		}
+	}
+}
+
+AShooterProjectile* AShooterProjectile::SpawnPooled(UWorld* World, TSubclassOf<AShooterProjectile> ProjectileClass, const FTransform& SpawnTM, bool bPrewarm)
+{
+	const ESpawnActorCollisionHandlingMethod CollisionHandling = bPrewarm ? ESpawnActorCollisionHandlingMethod::AlwaysSpawn : ESpawnActorCollisionHandlingMethod::Undefined;
+	AShooterProjectile* Projectile = World->SpawnActorDeferred<AShooterProjectile>(ProjectileClass, SpawnTM, nullptr, nullptr, CollisionHandling);
+	if (Projectile)
+	{
+		Projectile->SetPooled(true);
+		if (bPrewarm)
+		{
+			// never touch the level before it is fired for real
+			Projectile->SetActorEnableCollision(false);
+			Projectile->SetActorHiddenInGame(true);
+		}
+		UGameplayStatics::FinishSpawningActor(Projectile, SpawnTM);
+	}
+
+	return Projectile;
+}
+
+void AShooterProjectile::ActivateFromPool(const FTransform& SpawnTM, AActor* InOwner, APawn* InInstigator, FVector& ShootDirection)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileActivate);
+	INC_DWORD_STAT(STAT_ProjectilesReused);
+
+	SetOwner(InOwner);
+	SetInstigator(InInstigator);
+	SetActorTransform(SpawnTM, false, nullptr, ETeleportType::ResetPhysics);
+
+	CollisionComp->MoveIgnoreActors.Reset();
+	CollisionComp->MoveIgnoreActors.Add(GetInstigator());
+
+	AShooterWeapon_Projectile* OwnerWeapon = Cast<AShooterWeapon_Projectile>(GetOwner());
+	if (OwnerWeapon)
+	{
+		OwnerWeapon->ApplyWeaponConfig(WeaponConfig);
+	}
+	MyController = GetInstigatorController();
+
+	bExploded = false;
+	PoolActivation++;
+	ResetForReuse();
+	InitVelocity(ShootDirection);
+	TryStartBatchedFlight();
+
+	SetLifeSpan( WeaponConfig.ProjectileLife );
+
+	// wake the actor up again, clients keep it while it's dormant so nothing is respawned
+	SetNetDormancy(DORM_Awake);
+	ForceNetUpdate();
+}
+
+void AShooterProjectile::ResetForReuse()
+{
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+
+	// the movement component lets go of the root when it stops
+	MovementComp->SetUpdatedComponent(CollisionComp);
+	MovementComp->SetComponentTickEnabled(!IsBatched());
+
+	if (ParticleComp->bAutoActivate)
+	{
+		ParticleComp->ActivateSystem(true);
+	}
+
+	UAudioComponent* ProjAudioComp = FindComponentByClass<UAudioComponent>();
+	if (ProjAudioComp && ProjAudioComp->bAutoActivate)
+	{
+		ProjAudioComp->Play();
+	}
+}
+
+void AShooterProjectile::DeactivateToPool()
+{
+	SetLifeSpan(0.0f);
+
+	if (IsBatched())
+	{
+		AShooterProjectileManager::Get(GetWorld())->RemoveProjectile(this);
+		Launch = FShooterProjectileLaunch();
+	}
+
+	MovementComp->StopMovementImmediately();
+	MovementComp->SetComponentTickEnabled(false);
+	ParticleComp->DeactivateSystem();
+
+	UAudioComponent* ProjAudioComp = FindComponentByClass<UAudioComponent>();
+	if (ProjAudioComp)
+	{
+		ProjAudioComp->Stop();
+	}
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+
+	SetOwner(NULL);
+	SetInstigator(NULL);
+	MyController.Reset();
+
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AShooterProjectile::LifeSpanExpired()
+{
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (bPooled && GameMode && GetLocalRole() == ROLE_Authority)
+	{
+		GameMode->ReleaseProjectile(this);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_ProjectilesDestroyed);
+	Super::LifeSpanExpired();
+}
+
 void AShooterProjectile::InitVelocity(FVector& ShootDirection)
 {
 	if (MovementComp)
@@ -74,11 +272,19 @@ void AShooterProjectile::OnImpact(const FHitResult& HitResult)
 
 void AShooterProjectile::Explode(const FHitResult& Impact)
 {
+	if (IsBatched())
+	{
+		AShooterProjectileManager::Get(GetWorld())->RemoveProjectile(this);
+	}
+
 	if (ParticleComp)
 	{
 		ParticleComp->Deactivate();
 	}
 
+	ExplodedLocation = Impact.ImpactPoint;
+	ExplodedNormal = Impact.ImpactNormal;
+
 	// effects and damage origin shouldn't be placed inside mesh at impact point
 	const FVector NudgedImpactLocation = Impact.ImpactPoint + Impact.ImpactNormal * 10.0f;
 
@@ -118,23 +324,37 @@ void AShooterProjectile::DisableAndDestroy()
 ///CODE_SNIPPET_START: AActor::GetActorLocation AActor::GetActorRotation
 void AShooterProjectile::OnRep_Exploded()
 {
+	// pooled projectiles are reset when fired again
+	if (!bExploded)
+	{
+		return;
+	}
+
 	FVector ProjDirection = GetActorForwardVector();
 
-	const FVector StartTrace = GetActorLocation() - ProjDirection * 200;
-	const FVector EndTrace = GetActorLocation() + ProjDirection * 150;
+	// trace around the replicated impact, the local location can already be past the surface that was hit
+	const FVector StartTrace = ExplodedLocation - ProjDirection * 50;
+	const FVector EndTrace = ExplodedLocation + ProjDirection * 50;
 	FHitResult Impact;
 	
 	if (!GetWorld()->LineTraceSingleByChannel(Impact, StartTrace, EndTrace, COLLISION_PROJECTILE, FCollisionQueryParams(SCENE_QUERY_STAT(ProjClient), true, GetInstigator())))
 	{
 		// failsafe
-		Impact.ImpactPoint = GetActorLocation();
-		Impact.ImpactNormal = -ProjDirection;
+		Impact.ImpactPoint = ExplodedLocation;
+		Impact.ImpactNormal = ExplodedNormal.IsNearlyZero() ? -ProjDirection : FVector(ExplodedNormal);
 	}
 
+	SetActorLocation(Impact.ImpactPoint);
+
 	Explode(Impact);
 }
 ///CODE_SNIPPET_END
 
+void AShooterProjectile::OnRep_PoolActivation()
+{
+	ResetForReuse();
+}
+
 void AShooterProjectile::PostNetReceiveVelocity(const FVector& NewVelocity)
 {
 	if (MovementComp)
@@ -148,4 +368,8 @@ void AShooterProjectile::GetLifetimeReplicatedProps( TArray< FLifetimeProperty >
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
 	
 	DOREPLIFETIME( AShooterProjectile, bExploded );
+	DOREPLIFETIME( AShooterProjectile, ExplodedLocation );
+	DOREPLIFETIME( AShooterProjectile, ExplodedNormal );
+	DOREPLIFETIME( AShooterProjectile, PoolActivation );
+	DOREPLIFETIME( AShooterProjectile, Launch );
 }
\ No newline at end of file
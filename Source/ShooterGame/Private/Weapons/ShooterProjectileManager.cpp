@@ -0,0 +1,196 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Weapons/ShooterProjectileManager.h"
+#include "Weapons/ShooterProjectile.h"
+
+DECLARE_CYCLE_STAT(TEXT("Batched Projectile Simulation"), STAT_BatchedProjectileSim, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Projectiles"), STAT_BatchedProjectiles, STATGROUP_ShooterGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Projectile Sweeps"), STAT_BatchedProjectileSweeps, STATGROUP_ShooterGame);
+
+static int32 BatchedProjectiles = 0;
+FAutoConsoleVariableRef CVarBatchedProjectiles(
+	TEXT("ShooterWeapon.BatchedProjectiles"),
+	BatchedProjectiles,
+	TEXT("Simulate straight line projectiles in one manager and replicate only their launch instead of their movement.")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static float BatchedProjectileStepTime = 1.0f / 60.0f;
+FAutoConsoleVariableRef CVarBatchedProjectileStepTime(
+	TEXT("ShooterWeapon.BatchedProjectileStepTime"),
+	BatchedProjectileStepTime,
+	TEXT("Fixed step (seconds) of the batched projectile simulation."),
+	ECVF_Default);
+
+/** upper limit of steps in one frame, so a hitch doesn't make the next frame even longer */
+static const int32 MaxStepsPerFrame = 8;
+
+AShooterProjectileManager::AShooterProjectileManager(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+	bReplicates = false;
+	StepRemainder = 0.0f;
+	bHasRemoved = false;
+}
+
+AShooterProjectileManager* AShooterProjectileManager::Get(UWorld* World)
+{
+	AShooterProjectileManager* Manager = Find(World);
+	if (Manager)
+	{
+		return Manager;
+	}
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.ObjectFlags |= RF_Transient;
+	return World->SpawnActor<AShooterProjectileManager>(SpawnInfo);
+}
+
+AShooterProjectileManager* AShooterProjectileManager::Find(UWorld* World)
+{
+	for (AShooterProjectileManager* Manager : TActorRange<AShooterProjectileManager>(World))
+	{
+		return Manager;
+	}
+
+	return NULL;
+}
+
+bool AShooterProjectileManager::IsEnabled()
+{
+	return BatchedProjectiles != 0;
+}
+
+void AShooterProjectileManager::AddProjectile(AShooterProjectile* Projectile, const FVector& Location, const FVector& Velocity, float Radius)
+{
+	RemoveProjectile(Projectile);
+
+	Projectiles.Add(Projectile);
+	Locations.Add(Location);
+	Velocities.Add(Velocity);
+	Radii.Add(Radius);
+}
+
+void AShooterProjectileManager::RemoveProjectile(AShooterProjectile* Projectile)
+{
+	const int32 Index = Projectiles.Find(Projectile);
+	if (Index != INDEX_NONE)
+	{
+		Projectiles[Index] = NULL;
+		bHasRemoved = true;
+	}
+}
+
+void AShooterProjectileManager::CompactRemoved()
+{
+	if (!bHasRemoved)
+	{
+		return;
+	}
+
+	for (int32 Idx = Projectiles.Num() - 1; Idx >= 0; Idx--)
+	{
+		if (Projectiles[Idx] == NULL || Projectiles[Idx]->IsPendingKill())
+		{
+			Projectiles.RemoveAtSwap(Idx, 1, false);
+			Locations.RemoveAtSwap(Idx, 1, false);
+			Velocities.RemoveAtSwap(Idx, 1, false);
+			Radii.RemoveAtSwap(Idx, 1, false);
+		}
+	}
+
+	bHasRemoved = false;
+}
+
+void AShooterProjectileManager::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	SCOPE_CYCLE_COUNTER(STAT_BatchedProjectileSim);
+	SET_DWORD_STAT(STAT_BatchedProjectiles, Projectiles.Num());
+
+	const float StepTime = FMath::Max(BatchedProjectileStepTime, 0.001f);
+	StepRemainder = FMath::Min(StepRemainder + DeltaSeconds, StepTime * MaxStepsPerFrame);
+
+	while (StepRemainder >= StepTime)
+	{
+		StepRemainder -= StepTime;
+		SimulateStep(StepTime);
+		CompactRemoved();
+	}
+
+	CompactRemoved();
+
+	// actors are moved once per frame, ahead by the part of a step not simulated yet
+	for (int32 Idx = 0; Idx < Projectiles.Num(); Idx++)
+	{
+		AShooterProjectile* Projectile = Projectiles[Idx];
+		if (Projectile == NULL || Projectile->IsPendingKill())
+		{
+			bHasRemoved = true;
+			continue;
+		}
+
+		Projectile->SetActorLocation(Locations[Idx] + Velocities[Idx] * StepRemainder);
+	}
+}
+
+void AShooterProjectileManager::SimulateStep(float StepTime)
+{
+	const bool bAuthority = (GetNetMode() != NM_Client);
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(BatchedProjectile), true);
+
+	for (int32 Idx = 0; Idx < Projectiles.Num(); Idx++)
+	{
+		AShooterProjectile* Projectile = Projectiles[Idx];
+		if (Projectile == NULL || Projectile->IsPendingKill())
+		{
+			bHasRemoved = true;
+			continue;
+		}
+
+		const FVector Start = Locations[Idx];
+		const FVector End = Start + Velocities[Idx] * StepTime;
+
+		INC_DWORD_STAT(STAT_BatchedProjectileSweeps);
+
+		const USphereComponent* CollisionComp = Projectile->GetCollisionComp();
+
+		Params.ClearIgnoredActors();
+		Params.AddIgnoredActor(Projectile);
+		for (AActor* IgnoredActor : CollisionComp->MoveIgnoreActors)
+		{
+			Params.AddIgnoredActor(IgnoredActor);
+		}
+
+		// only the server decides impacts, clients stop at level geometry so the projectile doesn't fly through walls until bExploded arrives
+		FCollisionResponseParams ResponseParams(CollisionComp->GetCollisionResponseToChannels());
+		if (!bAuthority)
+		{
+			ResponseParams.CollisionResponse.SetResponse(ECC_Pawn, ECR_Ignore);
+		}
+
+		FHitResult Hit;
+		if (GetWorld()->SweepSingleByChannel(Hit, Start, End, FQuat::Identity, CollisionComp->GetCollisionObjectType(), FCollisionShape::MakeSphere(Radii[Idx]), Params, ResponseParams))
+		{
+			Locations[Idx] = Hit.Location;
+			Projectile->SetActorLocation(Hit.Location);
+
+			if (bAuthority)
+			{
+				Projectile->OnImpact(Hit);
+			}
+			else
+			{
+				Projectiles[Idx] = NULL;
+				bHasRemoved = true;
+			}
+			continue;
+		}
+
+		Locations[Idx] = End;
+	}
+}
@@ -4,10 +4,108 @@
 #include "Weapons/ShooterWeapon_Instant.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Effects/ShooterImpactEffect.h"
+#include "Effects/ShooterImpactEffectManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Rewind Hit Verification"), STAT_RewindHitVerify, STATGROUP_ShooterGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rewind Hits Accepted"), STAT_RewindHitsAccepted, STATGROUP_ShooterGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rewind Hits Rejected"), STAT_RewindHitsRejected, STATGROUP_ShooterGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Batched Shots Sent"), STAT_BatchedShotsSent, STATGROUP_ShooterGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Batched Notifies Sent"), STAT_BatchedNotifiesSent, STATGROUP_ShooterGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Shot Streams Started"), STAT_ShotStreamsStarted, STATGROUP_ShooterGame);
+
+static int32 BatchHitNotifies = 0;
+FAutoConsoleVariableRef CVarBatchHitNotifies(
+	TEXT("ShooterWeapon.BatchHitNotifies"),
+	BatchHitNotifies,
+	TEXT("Send hits and misses of instant weapons to the server in one quantized notify per frame instead of one RPC per shot.")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static float HitNotifyBatchWindow = 0.0f;
+FAutoConsoleVariableRef CVarHitNotifyBatchWindow(
+	TEXT("ShooterWeapon.HitNotifyBatchWindow"),
+	HitNotifyBatchWindow,
+	TEXT("How long (seconds) batched shots may wait before being sent. Anything above 0 delays damage on the server.")
+	TEXT("0: Send at the end of the frame the shots were fired"),
+	ECVF_Default);
+
+static int32 MaxSimulatedShotsPerUpdate = 4;
+FAutoConsoleVariableRef CVarMaxSimulatedShotsPerUpdate(
+	TEXT("ShooterWeapon.MaxSimulatedShotsPerUpdate"),
+	MaxSimulatedShotsPerUpdate,
+	TEXT("Max number of shots a remote client rebuilds from one shot stream update. Older shots are skipped."),
+	ECVF_Default);
+
+static float SimulatedTraceMaxDistance = 0.0f;
+FAutoConsoleVariableRef CVarSimulatedTraceMaxDistance(
+	TEXT("ShooterWeapon.SimulatedTraceMaxDistance"),
+	SimulatedTraceMaxDistance,
+	TEXT("Remote shooters further than this (uu) from the local view don't trace their shots, trails are drawn to max range without impact effects.")
+	TEXT("0: Always trace"),
+	ECVF_Scalability);
+
+/** upper limit of shots in one batched notify, also enforced by the server */
+static const int32 MaxShotsPerBatch = 32;
+
+bool FInstantShotInfo::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	uint8 bHit = bBlockingHit;
+	Ar.SerializeBits(&bHit, 1);
+	bBlockingHit = bHit;
+
+	uint8 bHasActor = (HitActor != nullptr);
+	Ar.SerializeBits(&bHasActor, 1);
+	if (bHasActor)
+	{
+		UObject* Actor = HitActor;
+		bOutSuccess &= Map->SerializeObject(Ar, AActor::StaticClass(), Actor);
+		HitActor = Cast<AActor>(Actor);
+	}
+	else if (Ar.IsLoading())
+	{
+		HitActor = nullptr;
+	}
+
+	if (bBlockingHit)
+	{
+		bool bPointSuccess = true;
+		bool bNormalSuccess = true;
+		ImpactPoint.NetSerialize(Ar, Map, bPointSuccess);
+		ImpactNormal.NetSerialize(Ar, Map, bNormalSuccess);
+		bOutSuccess &= bPointSuccess && bNormalSuccess;
+	}
+
+	bool bDirSuccess = true;
+	ShootDir.NetSerialize(Ar, Map, bDirSuccess);
+	bOutSuccess &= bDirSuccess;
+
+	uint32 Seed = (uint32)RandomSeed;
+	Ar.SerializeIntPacked(Seed);
+	RandomSeed = (int32)Seed;
+
+	uint16 QuantizedSpread = (uint16)FMath::Clamp(FMath::RoundToInt(ReticleSpread * 100.0f), 0, MAX_uint16);
+	Ar << QuantizedSpread;
+	if (Ar.IsLoading())
+	{
+		ReticleSpread = QuantizedSpread / 100.0f;
+	}
+
+	return true;
+}
 
 AShooterWeapon_Instant::AShooterWeapon_Instant(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	CurrentFiringSpread = 0.0f;
+	SimulatedBaseSeed = 0;
+	SimulatedShotCount = 0;
+	SimulatedNextSeed = 0;
+	StreamNextSeed = 0;
+	bReceivedShotStream = false;
+	BurstNextSeed = 0;
+	bPendingShotsNeedReliable = false;
+	PendingShotsTime = 0.0f;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -15,7 +113,8 @@ AShooterWeapon_Instant::AShooterWeapon_Instant(const FObjectInitializer& ObjectI
 
 void AShooterWeapon_Instant::FireWeapon()
 {
-	const int32 RandomSeed = FMath::Rand();
+	const int32 RandomSeed = BurstNextSeed;
+	BurstNextSeed = FInstantShotStream::GetNextShotSeed(BurstNextSeed);
 	FRandomStream WeaponRandomStream(RandomSeed);
 	const float CurrentSpread = GetCurrentSpread();
 	const float ConeHalfAngle = FMath::DegreesToRadians(CurrentSpread * 0.5f);
@@ -31,12 +130,12 @@ void AShooterWeapon_Instant::FireWeapon()
 	CurrentFiringSpread = FMath::Min(InstantConfig.FiringSpreadMax, CurrentFiringSpread + InstantConfig.FiringSpreadIncrement);
 }
 
-bool AShooterWeapon_Instant::ServerNotifyHit_Validate(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+bool AShooterWeapon_Instant::ServerNotifyHit_Validate(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread, float ClientServerTime)
 {
 	return true;
 }
 
-void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread, float ClientServerTime)
 {
 	const float WeaponAngleDot = FMath::Abs(FMath::Sin(ReticleSpread * PI / 180.f));
 
@@ -65,6 +164,17 @@ void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult& Im
 				{
 					ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
 				}
+				else if (CanVerifyRewoundHit(Impact))
+				{
+					if (VerifyRewoundHit(Impact, ClientServerTime))
+					{
+						ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
+					}
+					else
+					{
+						UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side hit of %s (outside rewound hit box)"), *GetNameSafe(this), *GetNameSafe(Impact.GetActor()));
+					}
+				}
 				else
 				{
 					// Get the component bounding box
@@ -107,6 +217,39 @@ void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult& Im
 	}
 }
 
+bool AShooterWeapon_Instant::CanVerifyRewoundHit(const FHitResult& Impact) const
+{
+	const AShooterCharacter* HitCharacter = Cast<AShooterCharacter>(Impact.GetActor());
+	return HitCharacter && HitCharacter->HasHitHistory();
+}
+
+bool AShooterWeapon_Instant::VerifyRewoundHit(const FHitResult& Impact, float ClientServerTime) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_RewindHitVerify);
+
+	const AShooterCharacter* HitCharacter = CastChecked<AShooterCharacter>(Impact.GetActor());
+
+	// Never trust the client further back than MaxRewindTime, or into the future
+	const float ServerTime = GetWorld()->GetTimeSeconds();
+	const float RewindTime = FMath::Clamp(ClientServerTime, ServerTime - InstantConfig.MaxRewindTime, ServerTime);
+
+	FBox HitBox;
+	if (HitCharacter->GetRewoundHitBox(RewindTime, HitBox) && HitBox.ExpandBy(InstantConfig.RewindHitLeeway).IsInside(Impact.Location))
+	{
+		INC_DWORD_STAT(STAT_RewindHitsAccepted);
+		return true;
+	}
+
+	INC_DWORD_STAT(STAT_RewindHitsRejected);
+	return false;
+}
+
+float AShooterWeapon_Instant::GetClientServerTime() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
 bool AShooterWeapon_Instant::ServerNotifyMiss_Validate(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
 {
 	return true;
@@ -117,9 +260,7 @@ void AShooterWeapon_Instant::ServerNotifyMiss_Implementation(FVector_NetQuantize
 	const FVector Origin = GetMuzzleLocation();
 
 	// play FX on remote clients
-	HitNotify.Origin = Origin;
-	HitNotify.RandomSeed = RandomSeed;
-	HitNotify.ReticleSpread = ReticleSpread;
+	AddShotToStream(Origin, RandomSeed, ReticleSpread);
 
 	// play FX locally
 	if (GetNetMode() != NM_DedicatedServer)
@@ -129,22 +270,158 @@ void AShooterWeapon_Instant::ServerNotifyMiss_Implementation(FVector_NetQuantize
 	}
 }
 
+bool AShooterWeapon_Instant::ServerNotifyShotBatch_Validate(const TArray<FInstantShotInfo>& Shots, float ClientServerTime)
+{
+	return Shots.Num() <= MaxShotsPerBatch;
+}
+
+void AShooterWeapon_Instant::ServerNotifyShotBatch_Implementation(const TArray<FInstantShotInfo>& Shots, float ClientServerTime)
+{
+	ProcessShotBatch(Shots, ClientServerTime);
+}
+
+bool AShooterWeapon_Instant::ServerNotifyMissBatch_Validate(const TArray<FInstantShotInfo>& Shots)
+{
+	return Shots.Num() <= MaxShotsPerBatch;
+}
+
+void AShooterWeapon_Instant::ServerNotifyMissBatch_Implementation(const TArray<FInstantShotInfo>& Shots)
+{
+	ProcessShotBatch(Shots, GetWorld()->GetTimeSeconds());
+}
+
+void AShooterWeapon_Instant::ProcessShotBatch(const TArray<FInstantShotInfo>& Shots, float ClientServerTime)
+{
+	for (const FInstantShotInfo& Shot : Shots)
+	{
+		if (Shot.bBlockingHit || Shot.HitActor)
+		{
+			// rebuild the parts of the hit result that verification and damage use
+			FHitResult Impact;
+			Impact.bBlockingHit = Shot.bBlockingHit;
+			Impact.Actor = Shot.HitActor;
+			Impact.Location = Shot.ImpactPoint;
+			Impact.ImpactPoint = Shot.ImpactPoint;
+			Impact.Normal = Shot.ImpactNormal;
+			Impact.ImpactNormal = Shot.ImpactNormal;
+
+			ServerNotifyHit_Implementation(Impact, Shot.ShootDir, Shot.RandomSeed, Shot.ReticleSpread, ClientServerTime);
+		}
+		else
+		{
+			ServerNotifyMiss_Implementation(Shot.ShootDir, Shot.RandomSeed, Shot.ReticleSpread);
+		}
+	}
+}
+
+void AShooterWeapon_Instant::QueueShot(const FHitResult& Impact, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread)
+{
+	if (PendingShots.Num() >= MaxShotsPerBatch)
+	{
+		FlushPendingShots();
+	}
+
+	if (PendingShots.Num() == 0)
+	{
+		PendingShotsTime = GetWorld()->GetTimeSeconds();
+		if (!PendingShotsFlushHandle.IsValid())
+		{
+			PendingShotsFlushHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &AShooterWeapon_Instant::OnWorldPostActorTick);
+		}
+	}
+
+	FInstantShotInfo& Shot = PendingShots.AddDefaulted_GetRef();
+	Shot.HitActor = Impact.GetActor();
+	Shot.bBlockingHit = Impact.bBlockingHit;
+	Shot.ImpactPoint = Impact.bBlockingHit ? Impact.Location : FVector::ZeroVector;
+	Shot.ImpactNormal = Impact.bBlockingHit ? Impact.ImpactNormal : FVector::ZeroVector;
+	Shot.ShootDir = ShootDir;
+	Shot.RandomSeed = RandomSeed;
+	Shot.ReticleSpread = ReticleSpread;
+
+	bPendingShotsNeedReliable |= (Impact.GetActor() || Impact.bBlockingHit);
+}
+
+void AShooterWeapon_Instant::FlushPendingShots()
+{
+	if (PendingShots.Num() > 0)
+	{
+		INC_DWORD_STAT_BY(STAT_BatchedShotsSent, PendingShots.Num());
+		INC_DWORD_STAT(STAT_BatchedNotifiesSent);
+
+		if (bPendingShotsNeedReliable)
+		{
+			// rewind to the oldest shot of the batch, not the time it is sent
+			const float BatchAge = GetWorld()->GetTimeSeconds() - PendingShotsTime;
+			ServerNotifyShotBatch(PendingShots, GetClientServerTime() - BatchAge);
+		}
+		else
+		{
+			ServerNotifyMissBatch(PendingShots);
+		}
+
+		PendingShots.Reset();
+		bPendingShotsNeedReliable = false;
+	}
+
+	if (PendingShotsFlushHandle.IsValid())
+	{
+		FWorldDelegates::OnWorldPostActorTick.Remove(PendingShotsFlushHandle);
+		PendingShotsFlushHandle.Reset();
+	}
+}
+
+void AShooterWeapon_Instant::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	// runs after timers and actor ticks but before the net driver sends, so a batch does not add a frame of latency
+	if (InWorld == GetWorld() && GetWorld()->GetTimeSeconds() - PendingShotsTime >= HitNotifyBatchWindow)
+	{
+		FlushPendingShots();
+	}
+}
+
+void AShooterWeapon_Instant::StopFire()
+{
+	// pending shots must reach the server before it goes idle and starts rejecting them
+	FlushPendingShots();
+
+	Super::StopFire();
+}
+
+void AShooterWeapon_Instant::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FlushPendingShots();
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AShooterWeapon_Instant::ProcessInstantHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread)
 {
-	if (MyPawn && MyPawn->IsLocallyControlled() && GetNetMode() == NM_Client)
+	if (MyPawn && MyPawn->IsLocallyControlled() && GetNetMode() == NM_Client && BatchHitNotifies)
+	{
+		// hits on actors the client simulates itself are never sent to the server
+		if (Impact.GetActor() == NULL || Impact.GetActor()->GetRemoteRole() == ROLE_Authority)
+		{
+			QueueShot(Impact, ShootDir, RandomSeed, ReticleSpread);
+		}
+	}
+	else if (MyPawn && MyPawn->IsLocallyControlled() && GetNetMode() == NM_Client)
 	{
+		// a batch may still be pending if batching was just turned off
+		FlushPendingShots();
+
 		// if we're a client and we've hit something that is being controlled by the server
 		if (Impact.GetActor() && Impact.GetActor()->GetRemoteRole() == ROLE_Authority)
 		{
 			// notify the server of the hit
-			ServerNotifyHit(Impact, ShootDir, RandomSeed, ReticleSpread);
+			ServerNotifyHit(Impact, ShootDir, RandomSeed, ReticleSpread, GetClientServerTime());
 		}
 		else if (Impact.GetActor() == NULL)
 		{
 			if (Impact.bBlockingHit)
 			{
 				// notify the server of the hit
-				ServerNotifyHit(Impact, ShootDir, RandomSeed, ReticleSpread);
+				ServerNotifyHit(Impact, ShootDir, RandomSeed, ReticleSpread, GetClientServerTime());
 			}
 			else
 			{
@@ -169,9 +446,7 @@ void AShooterWeapon_Instant::ProcessInstantHit_Confirmed(const FHitResult& Impac
 	// play FX on remote clients
 	if (GetLocalRole() == ROLE_Authority)
 	{
-		HitNotify.Origin = Origin;
-		HitNotify.RandomSeed = RandomSeed;
-		HitNotify.ReticleSpread = ReticleSpread;
+		AddShotToStream(Origin, RandomSeed, ReticleSpread);
 	}
 
 	// play FX locally
@@ -212,11 +487,25 @@ void AShooterWeapon_Instant::DealDamage(const FHitResult& Impact, const FVector&
 	Impact.GetActor()->TakeDamage(PointDmg.Damage, PointDmg, MyPawn->Controller, this);
 }
 
+void AShooterWeapon_Instant::OnBurstStarted()
+{
+	// chained seeds let the server replicate the whole burst as one seed and a shot count
+	BurstNextSeed = FMath::Rand();
+
+	Super::OnBurstStarted();
+}
+
 void AShooterWeapon_Instant::OnBurstFinished()
 {
 	Super::OnBurstFinished();
 
 	CurrentFiringSpread = 0.0f;
+
+	// don't hold the last shots of a burst back for the batch window
+	if (PendingShots.Num() > 0)
+	{
+		FlushPendingShots();
+	}
 }
 
 
@@ -238,9 +527,48 @@ float AShooterWeapon_Instant::GetCurrentSpread() const
 //////////////////////////////////////////////////////////////////////////
 // Replication & effects
 
-void AShooterWeapon_Instant::OnRep_HitNotify()
+void AShooterWeapon_Instant::AddShotToStream(const FVector& Origin, int32 RandomSeed, float ReticleSpread)
+{
+	const bool bContinuesStream = ShotStream.ShotCount > 0 && RandomSeed == StreamNextSeed;
+	if (!bContinuesStream)
+	{
+		INC_DWORD_STAT(STAT_ShotStreamsStarted);
+		ShotStream.BaseSeed = RandomSeed;
+		ShotStream.ShotCount = 0;
+	}
+
+	// remote clients rebuild every shot of the stream from the base seed
+	checkSlow(FInstantShotStream::GetShotSeed(ShotStream.BaseSeed, ShotStream.ShotCount) == RandomSeed);
+
+	ShotStream.ShotCount++;
+	StreamNextSeed = FInstantShotStream::GetNextShotSeed(RandomSeed);
+	ShotStream.Origin = Origin;
+	ShotStream.ReticleSpread = ReticleSpread;
+}
+
+void AShooterWeapon_Instant::OnRep_ShotStream()
 {
-	SimulateInstantHit(HitNotify.Origin, HitNotify.RandomSeed, HitNotify.ReticleSpread);
+	// shots between two updates are rebuilt from the seed, only the latest origin and spread are known
+	const bool bSameStream = (ShotStream.BaseSeed == SimulatedBaseSeed);
+	const uint16 FirstShot = bSameStream ? SimulatedShotCount : 0;
+	const uint16 NewShots = ShotStream.ShotCount - FirstShot;
+
+	// a late joining proxy only shows the latest shot, and only if the weapon is still firing
+	const int32 MaxShots = bReceivedShotStream ? FMath::Max(1, MaxSimulatedShotsPerUpdate) : (BurstCounter > 0 ? 1 : 0);
+	const uint16 NumToSimulate = (uint16)FMath::Min<int32>(NewShots, MaxShots);
+
+	// step from the last simulated shot, skipping the ones over the limit
+	int32 ShotSeed = FInstantShotStream::GetShotSeed(bSameStream ? SimulatedNextSeed : ShotStream.BaseSeed, NewShots - NumToSimulate);
+	for (uint16 Offset = NewShots - NumToSimulate; Offset < NewShots; Offset++)
+	{
+		SimulateInstantHit(ShotStream.Origin, ShotSeed, ShotStream.ReticleSpread);
+		ShotSeed = FInstantShotStream::GetNextShotSeed(ShotSeed);
+	}
+
+	SimulatedNextSeed = ShotSeed;
+	SimulatedBaseSeed = ShotStream.BaseSeed;
+	SimulatedShotCount = ShotStream.ShotCount;
+	bReceivedShotStream = true;
 }
 
 void AShooterWeapon_Instant::SimulateInstantHit(const FVector& ShotOrigin, int32 RandomSeed, float ReticleSpread)
@@ -253,6 +581,12 @@ void AShooterWeapon_Instant::SimulateInstantHit(const FVector& ShotOrigin, int32
 	const FVector ShootDir = WeaponRandomStream.VRandCone(AimDir, ConeHalfAngle, ConeHalfAngle);
 	const FVector EndTrace = StartTrace + ShootDir * InstantConfig.WeaponRange;
 
+	if (SimulatedTraceMaxDistance > 0.0f && !IsNearLocalView(StartTrace, SimulatedTraceMaxDistance))
+	{
+		SpawnTrailEffect(EndTrace);
+		return;
+	}
+
 	FHitResult Impact = WeaponTrace(StartTrace, EndTrace);
 	if (Impact.bBlockingHit)
 	{
@@ -265,10 +599,36 @@ void AShooterWeapon_Instant::SimulateInstantHit(const FVector& ShotOrigin, int32
 	}
 }
 
+bool AShooterWeapon_Instant::IsNearLocalView(const FVector& Location, float MaxDistance) const
+{
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			if (FVector::DistSquared(ViewLocation, Location) <= FMath::Square(MaxDistance))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 void AShooterWeapon_Instant::SpawnImpactEffects(const FHitResult& Impact)
 {
 	if (ImpactTemplate && Impact.bBlockingHit)
 	{
+		if (AShooterImpactEffectManager::IsEnabled())
+		{
+			AShooterImpactEffectManager::Get(GetWorld())->QueueImpact(ImpactTemplate, Impact);
+			return;
+		}
+
 		FHitResult UseImpact = Impact;
 
 		// trace again to find component lost during replication
@@ -308,5 +668,5 @@ void AShooterWeapon_Instant::GetLifetimeReplicatedProps( TArray< FLifetimeProper
 {
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
 
-	DOREPLIFETIME_CONDITION( AShooterWeapon_Instant, HitNotify, COND_SkipOwner );
+	DOREPLIFETIME_CONDITION( AShooterWeapon_Instant, ShotStream, COND_SkipOwner );
 }
\ No newline at end of file
@@ -4,10 +4,32 @@
 #include "Weapons/ShooterWeapon_Projectile.h"
 #include "Weapons/ShooterProjectile.h"
 
+DECLARE_CYCLE_STAT(TEXT("Projectile Spawn"), STAT_ProjectileSpawn, STATGROUP_ShooterGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Spawned"), STAT_ProjectilesSpawned, STATGROUP_ShooterGame);
+
+static int32 ProjectilePoolSize = 8;
+FAutoConsoleVariableRef CVarProjectilePoolSize(
+	TEXT("ShooterWeapon.ProjectilePoolSize"),
+	ProjectilePoolSize,
+	TEXT("Number of projectiles spawned up front per projectile class. Exploded projectiles go back to the pool instead of being destroyed.")
+	TEXT("0: Disable pooling"),
+	ECVF_Default);
+
 AShooterWeapon_Projectile::AShooterWeapon_Projectile(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 }
 
+void AShooterWeapon_Projectile::BeginPlay()
+{
+	Super::BeginPlay();
+
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (GameMode && ProjectilePoolSize > 0 && ProjectileConfig.ProjectileClass)
+	{
+		GameMode->PrewarmProjectiles(ProjectileConfig.ProjectileClass, ProjectilePoolSize);
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Weapon usage
 
@@ -71,13 +93,30 @@ bool AShooterWeapon_Projectile::ServerFireProjectile_Validate(FVector Origin, FV
 
 void AShooterWeapon_Projectile::ServerFireProjectile_Implementation(FVector Origin, FVector_NetQuantizeNormal ShootDir)
 {
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileSpawn);
+
 	FTransform SpawnTM(ShootDir.Rotation(), Origin);
+	FVector ShootDirection = ShootDir;
+
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	const bool bUsePool = GameMode && ProjectilePoolSize > 0;
+
+	AShooterProjectile* PooledProjectile = bUsePool ? GameMode->AcquireProjectile(ProjectileConfig.ProjectileClass) : NULL;
+	if (PooledProjectile)
+	{
+		PooledProjectile->ActivateFromPool(SpawnTM, this, GetInstigator(), ShootDirection);
+		return;
+	}
+
 	AShooterProjectile* Projectile = Cast<AShooterProjectile>(UGameplayStatics::BeginDeferredActorSpawnFromClass(this, ProjectileConfig.ProjectileClass, SpawnTM));
 	if (Projectile)
 	{
+		INC_DWORD_STAT(STAT_ProjectilesSpawned);
+
 		Projectile->SetInstigator(GetInstigator());
 		Projectile->SetOwner(this);
-		Projectile->InitVelocity(ShootDir);
+		Projectile->InitVelocity(ShootDirection);
+		Projectile->SetPooled(bUsePool);
 
 		UGameplayStatics::FinishSpawningActor(Projectile, SpawnTM);
 	}
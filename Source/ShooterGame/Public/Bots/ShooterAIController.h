@@ -7,6 +7,17 @@
 class UBehaviorTreeComponent;
 class UBlackboardComponent;
 
+/** Line of sight checks bots cache per target. Each kind is one trace (start, end and channel), every caller of that trace shares its results. */
+enum class EShooterLOSQuery : uint8
+{
+	/** HasWeaponLOSToEnemy, only the target counts */
+	Weapon,
+	/** HasWeaponLOSToEnemy, any enemy in the way counts; also used by UBTDecorator_HasLoSTo for actor targets */
+	WeaponAnyEnemy,
+	/** LineOfSightTo from the bot, used by ShootEnemy */
+	Controller,
+};
+
 UCLASS(config=Game)
 class AShooterAIController : public AAIController
 {
@@ -52,6 +63,12 @@ public:
 		
 	bool HasWeaponLOSToEnemy(AActor* InEnemyActor, const bool bAnyEnemy) const;
 
+	/** get a line of sight result for the target that is still valid, returns false if it has to be traced again */
+	bool FindCachedLOS(const AActor* Target, EShooterLOSQuery Query, bool& bOutHasLOS) const;
+
+	/** remember a traced line of sight result for the target */
+	void StoreCachedLOS(const AActor* Target, EShooterLOSQuery Query, bool bHasLOS) const;
+
 	// Begin AAIController interface
 	/** Update direction AI is looking based on FocalPoint */
 	virtual void UpdateControlRotation(float DeltaTime, bool bUpdatePawn = true) override;
@@ -67,6 +84,17 @@ protected:
 	/** Handle for efficient management of Respawn timer */
 	FTimerHandle TimerHandle_Respawn;
 
+	struct FCachedLOS
+	{
+		/** frame and time the result was traced */
+		uint64 Frame;
+		float Time;
+		bool bHasLOS;
+	};
+
+	/** line of sight results per target and kind of check */
+	mutable TMap<TPair<TWeakObjectPtr<const AActor>, EShooterLOSQuery>, FCachedLOS> LOSCache;
+
 public:
 	/** Returns BlackboardComp subobject **/
 	FORCEINLINE UBlackboardComponent* GetBlackboardComp() const { return BlackboardComp; }
@@ -0,0 +1,62 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+class AController;
+class AShooterCharacter;
+
+/**
+ * Grid of live characters shared by all bots of a world, so enemy acquisition doesn't walk every pawn per bot.
+ * Rebuilt lazily on the first query of each frame.
+ */
+class FShooterEnemyIndex
+{
+public:
+
+	FShooterEnemyIndex();
+
+	/** 
+	 * Finds up to MaxResults live enemies of ForController, nearest first.
+	 * MaxResults <= 0 returns all of them.
+	 */
+	void FindNearestEnemies(UWorld* World, AController* ForController, const FVector& Location, int32 MaxResults, TArray<AShooterCharacter*>& OutEnemies, const AShooterCharacter* ExcludeEnemy = nullptr);
+
+	/** count a line of sight trace done by a bot, for the traces per bot per second stat */
+	void NotifyLOSTrace();
+
+private:
+
+	struct FEntry
+	{
+		AShooterCharacter* Character;
+		FVector Location;
+	};
+
+	/** rebuild the grid if it wasn't built this frame */
+	void UpdateIndex(UWorld* World);
+
+	/** cell containing a location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** live characters, indexed by the cells */
+	TArray<FEntry> Entries;
+
+	/** entry indices per cell */
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	/** bounds of occupied cells, limits the ring search */
+	FIntPoint MinCell;
+	FIntPoint MaxCell;
+
+	/** cell size the grid was built with */
+	float CellSize;
+
+	/** frame the grid was built in */
+	uint64 LastUpdateFrame;
+
+	/** LOS traces since the stat was last updated */
+	int32 NumLOSTraces;
+
+	/** world time the stat was last updated */
+	float LastStatTime;
+};
@@ -97,6 +97,9 @@ class AShooterImpactEffect : public AActor
 	/** spawn effect */
 	virtual void PostInitializeComponents() override;
 
+	/** play FX, sound and decal for a surface hit without an actor, called on the template by the impact effect manager */
+	UDecalComponent* PlayImpact(UWorld* World, const FVector& Location, const FRotator& Rotation, const FHitResult& Hit, bool bPlaySound, bool bSpawnDecal) const;
+
 protected:
 
 	/** get FX for material type */
@@ -0,0 +1,70 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GameFramework/Actor.h"
+#include "ShooterImpactEffectManager.generated.h"
+
+class AShooterImpactEffect;
+class UDecalComponent;
+
+/** impact waiting to be played by the impact effect manager */
+struct FShooterImpactRecord
+{
+	/** effect template, only its defaults are used */
+	const AShooterImpactEffect* Template;
+
+	/** impact location */
+	FVector Location;
+
+	/** surface normal */
+	FVector Normal;
+
+	/** hit component, may be lost during replication */
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+
+	/** hit bone */
+	FName BoneName;
+
+	/** hit physical material */
+	TWeakObjectPtr<UPhysicalMaterial> PhysMaterial;
+
+	/** world time the impact was queued */
+	float QueuedTime;
+};
+
+/**
+ * Plays weapon impact effects of a world from queued records, without spawning an actor per hit.
+ * Hits on the same surface are coalesced, a few impacts are played per frame and far away ones skip their sound and decal.
+ */
+UCLASS(NotPlaceable, Transient)
+class AShooterImpactEffectManager : public AActor
+{
+	GENERATED_UCLASS_BODY()
+
+	/** get the manager of a world, spawning it on first use */
+	static AShooterImpactEffectManager* Get(UWorld* World);
+
+	/** check if impact effects should be played by the manager */
+	static bool IsEnabled();
+
+	/** queue an impact effect */
+	void QueueImpact(TSubclassOf<AShooterImpactEffect> ImpactTemplate, const FHitResult& Impact);
+
+	/** play queued impacts within the frame budget */
+	virtual void Tick(float DeltaSeconds) override;
+
+private:
+
+	/** play a single impact */
+	void PlayRecord(const FShooterImpactRecord& Record, TArrayView<const FVector> ViewLocations);
+
+	/** remember a new decal, removing the oldest ones over the limit */
+	void AddDecal(UDecalComponent* Decal);
+
+	/** impacts waiting to be played, oldest first */
+	TArray<FShooterImpactRecord> PendingImpacts;
+
+	/** decals spawned by the manager, oldest first */
+	TArray<TWeakObjectPtr<UDecalComponent>> ActiveDecals;
+};
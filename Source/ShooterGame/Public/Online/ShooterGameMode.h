@@ -4,11 +4,15 @@
 
 #include "OnlineIdentityInterface.h"
 #include "ShooterPlayerController.h"
+#include "Bots/ShooterEnemyIndex.h"
+#include "Pickups/ShooterPickupRegistry.h"
+#include "Online/ShooterSpawnSelector.h"
 #include "ShooterGameMode.generated.h"
 
 class AShooterAIController;
 class AShooterPlayerState;
 class AShooterPickup;
+class AShooterProjectile;
 class FUniqueNetId;
 
 UCLASS(config=Game)
@@ -159,4 +163,41 @@ public:
 	UPROPERTY()
 	TArray<AShooterPickup*> LevelPickups;
 
+	/** live characters for bot enemy queries */
+	FShooterEnemyIndex& GetEnemyIndex() { return EnemyIndex; }
+
+	/** level pickups for bot pickup queries */
+	FShooterPickupRegistry& GetPickupRegistry() { return PickupRegistry; }
+
+	/** take an inactive projectile of the given class from the pool, returns NULL if there is none */
+	AShooterProjectile* AcquireProjectile(TSubclassOf<AShooterProjectile> ProjectileClass);
+
+	/** put a projectile that exploded or expired back in the pool, or destroy it if the pool of its class is full */
+	void ReleaseProjectile(AShooterProjectile* Projectile);
+
+	/** spawn inactive projectiles until the pool has Count of the given class, and keep at most that many idle */
+	void PrewarmProjectiles(TSubclassOf<AShooterProjectile> ProjectileClass, int32 Count);
+
+private:
+
+	/** inactive projectiles ready to be fired again */
+	UPROPERTY(Transient)
+	TArray<AShooterProjectile*> ProjectilePool;
+
+	/** number of idle projectiles kept per class, the largest prewarm count asked for */
+	UPROPERTY(Transient)
+	TMap<UClass*, int32> ProjectilePoolSizes;
+
+	/** live characters for bot enemy queries, characters are only referenced for the frame it was built in */
+	FShooterEnemyIndex EnemyIndex;
+
+	/** level pickups for bot pickup queries, pickups unregister in EndPlay */
+	FShooterPickupRegistry PickupRegistry;
+
+	/** cached starts and pawn grid for choosing player starts */
+	FShooterSpawnSelector SpawnSelector;
+
+	/** uses IsSpawnpointAllowed to build its spawn filters */
+	friend class FShooterSpawnSelector;
+
 };
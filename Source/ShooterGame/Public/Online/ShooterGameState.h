@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "Online/ShooterScoreboardStats.h"
 #include "ShooterGameState.generated.h"
 
 /** ranked PlayerState map, created from the GameState */
@@ -30,8 +31,53 @@ public:
 	UPROPERTY(Transient, Replicated)
 	bool bTimerPaused;
 
+	/** packed stats of all players, read by scoreboards, HUD and end of match stats */
+	const FShooterScoreboardStats& GetScoreboardStats() const { return ScoreboardStats; }
+
+	/** [server] copy a player's current stats into the scoreboard stats */
+	void UpdateScoreboardStats(AShooterPlayerState* PlayerState);
+
 	/** gets ranked PlayerState map for specific team */
 	void GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const;	
 
+	/** gets ranked PlayerState map for specific team without copying it, teams are only re-sorted after a score or team changed */
+	const RankedPlayerMap& GetCachedRankedMap(int32 TeamIndex) const;
+
+	/** changes whenever any team's ranking may have changed */
+	uint32 GetRankingVersion() const { return RankingVersion; }
+
+	/** re-sort the team of a player whose score changed */
+	void NotifyPlayerScoreChanged(AShooterPlayerState* PlayerState);
+
+	/** rebuild all teams after players joined, left or changed team */
+	void NotifyPlayerTeamsChanged();
+
+	virtual void AddPlayerState(APlayerState* PlayerState) override;
+	virtual void RemovePlayerState(APlayerState* PlayerState) override;
+
 	void RequestFinishAndExitToMainMenu();
+
+private:
+
+	/** stats of all players, replicated as one fast array */
+	UPROPERTY(Transient, Replicated)
+	FShooterScoreboardStats ScoreboardStats;
+
+	/** rebuild dirty rankings */
+	void UpdateRankings() const;
+
+	/** players of each team, best score first */
+	mutable TArray<TArray<TWeakObjectPtr<AShooterPlayerState>>> RankedPlayers;
+
+	/** ranked maps of each team, built from RankedPlayers */
+	mutable TArray<RankedPlayerMap> RankedMaps;
+
+	/** teams that need sorting */
+	mutable TBitArray<> DirtyTeams;
+
+	/** team membership changed, all teams need rebuilding */
+	mutable bool bRankedTeamsDirty;
+
+	/** incremented on every ranking notification */
+	uint32 RankingVersion;
 };
@@ -60,6 +60,9 @@ class AShooterPlayerState : public APlayerState
 	/** get whether the player quit the match */
 	bool IsQuitter() const;
 
+	/** [server] check if this player killed, or was killed by, Other within the last MaxAge seconds */
+	bool HasRecentlyFought(const AShooterPlayerState* Other, float MaxAge) const;
+
 	/** gets truncated player name to fit in death log and scoreboards */
 	FString GetShortPlayerName() const;
 
@@ -75,6 +78,9 @@ class AShooterPlayerState : public APlayerState
 	UFUNCTION()
 	void OnRep_TeamColor();
 
+	/** re-rank the player on the scoreboard */
+	virtual void OnRep_Score() override;
+
 	//We don't need stats about amount of ammo fired to be server authenticated, so just increment these with local functions
 	void AddBulletsFired(int32 NumBullets);
 	void AddRocketsFired(int32 NumRockets);
@@ -88,6 +94,12 @@ protected:
 	/** Set the mesh colors based on the current teamnum variable */
 	void UpdateTeamColors();
 
+	/** tell the game state the scoreboard ranking changed */
+	void NotifyRankingChanged(bool bTeamChanged);
+
+	/** [server] copy stats into the game state's scoreboard stats */
+	void UpdateScoreboardStats();
+
 	/** team number */
 	UPROPERTY(Transient, ReplicatedUsing=OnRep_TeamColor)
 	int32 TeamNumber;
@@ -112,6 +124,18 @@ protected:
 	UPROPERTY()
 	uint8 bQuitter : 1;
 
+	/** [server] last player killed by this player */
+	TWeakObjectPtr<AShooterPlayerState> LastVictim;
+
+	/** [server] time of the last kill */
+	float LastVictimTime;
+
+	/** [server] last player that killed this player */
+	TWeakObjectPtr<AShooterPlayerState> LastKiller;
+
+	/** [server] time of the last death */
+	float LastKillerTime;
+
 	/** helper for scoring points */
 	void ScorePoints(int32 Points);
 };
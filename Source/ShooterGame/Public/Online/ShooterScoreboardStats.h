@@ -0,0 +1,160 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/NetSerialization.h"
+#include "ShooterScoreboardStats.generated.h"
+
+class AShooterPlayerState;
+struct FShooterScoreboardStats;
+
+namespace EShooterScoreboardStat
+{
+	enum Type
+	{
+		Kills,
+		Deaths,
+		Score,
+		BulletsFired,
+		RocketsFired,
+		Num,
+	};
+}
+
+/** replicated scoreboard row of one player */
+USTRUCT()
+struct FShooterScoreboardStatsItem : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** player the row belongs to */
+	UPROPERTY()
+	AShooterPlayerState* PlayerState;
+
+	UPROPERTY()
+	int32 PlayerId;
+
+	UPROPERTY()
+	int32 TeamNum;
+
+	UPROPERTY()
+	int32 Kills;
+
+	UPROPERTY()
+	int32 Deaths;
+
+	UPROPERTY()
+	int32 Score;
+
+	UPROPERTY()
+	int32 BulletsFired;
+
+	UPROPERTY()
+	int32 RocketsFired;
+
+	FShooterScoreboardStatsItem()
+		: PlayerState(nullptr)
+		, PlayerId(INDEX_NONE)
+		, TeamNum(0)
+		, Kills(0)
+		, Deaths(0)
+		, Score(0)
+		, BulletsFired(0)
+		, RocketsFired(0)
+	{
+	}
+
+	/** stat by type */
+	int32 GetStat(EShooterScoreboardStat::Type Stat) const;
+
+	/** [client] rows changed, the packed columns need rebuilding */
+	void PostReplicatedAdd(const FShooterScoreboardStats& InArraySerializer);
+	void PostReplicatedChange(const FShooterScoreboardStats& InArraySerializer);
+	void PreReplicatedRemove(const FShooterScoreboardStats& InArraySerializer);
+};
+
+/**
+ * Scoreboard stats of all players, replicated as one fast array and read from packed per stat columns.
+ * Rows are in no particular order, use the game state's ranked maps for ranking.
+ */
+USTRUCT()
+struct FShooterScoreboardStats : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	FShooterScoreboardStats()
+		: bColumnsDirty(false)
+	{
+	}
+
+	/** [server] copy the current stats of a player into its row, adding the row if needed */
+	void UpdatePlayer(AShooterPlayerState* PlayerState);
+
+	/** [server] remove the row of a player */
+	void RemovePlayer(AShooterPlayerState* PlayerState);
+
+	/** number of rows */
+	int32 Num() const;
+
+	/** row of a player, INDEX_NONE if it has none */
+	int32 FindRow(const AShooterPlayerState* PlayerState) const;
+
+	/** player of a row */
+	AShooterPlayerState* GetPlayerState(int32 Row) const;
+
+	/** player id of a row */
+	int32 GetPlayerId(int32 Row) const;
+
+	/** team of a row */
+	int32 GetTeamNum(int32 Row) const;
+
+	/** stat of a row */
+	int32 GetStat(int32 Row, EShooterScoreboardStat::Type Stat) const;
+
+	/** stat of a player, 0 if it has no row */
+	int32 GetPlayerStat(const AShooterPlayerState* PlayerState, EShooterScoreboardStat::Type Stat) const;
+
+	/** sum of a stat over a team */
+	int32 GetTeamTotal(int32 TeamNum, EShooterScoreboardStat::Type Stat) const;
+
+	/** mark the columns for rebuilding */
+	void MarkColumnsDirty() const { bColumnsDirty = true; }
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FShooterScoreboardStatsItem, FShooterScoreboardStats>(Items, DeltaParms, *this);
+	}
+
+private:
+
+	/** rebuild the packed columns from the rows if they changed */
+	void UpdateColumns() const;
+
+	/** replicated rows */
+	UPROPERTY()
+	TArray<FShooterScoreboardStatsItem> Items;
+
+	/** packed players, one per row */
+	mutable TArray<const AShooterPlayerState*> PlayerStates;
+
+	/** packed player ids, one per row */
+	mutable TArray<int32> PlayerIds;
+
+	/** packed teams, one per row */
+	mutable TArray<int32> TeamNums;
+
+	/** packed stats, one column per stat and one entry per row */
+	mutable TArray<int32> StatColumns[EShooterScoreboardStat::Num];
+
+	/** rows changed since the columns were built */
+	mutable bool bColumnsDirty;
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterScoreboardStats> : public TStructOpsTypeTraitsBase2<FShooterScoreboardStats>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
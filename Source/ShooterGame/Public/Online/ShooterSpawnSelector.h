@@ -0,0 +1,94 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+class AShooterGameMode;
+class APlayerStart;
+
+/**
+ * Chooses player starts from cached starts and a grid of pawns rebuilt once per frame, instead of testing every pawn against every start.
+ * Starts picked in a frame count as occupied for the rest of it, so a mass respawn is answered in one pass over the pawns.
+ */
+class FShooterSpawnSelector
+{
+public:
+
+	FShooterSpawnSelector();
+
+	/** check if starts should be chosen by the selector */
+	static bool IsEnabled();
+
+	/** pick a random unoccupied start Player is allowed to use, least dangerous first; NULL if there is no allowed start */
+	APlayerStart* ChooseStart(AShooterGameMode* GameMode, AController* Player);
+
+	/** forget cached starts and spawn filters, e.g. after team setup changed */
+	void Reset();
+
+private:
+
+	struct FStartInfo
+	{
+		TWeakObjectPtr<APlayerStart> Start;
+		FVector Location;
+	};
+
+	struct FPawnEntry
+	{
+		/** character, NULL for starts claimed this frame */
+		ACharacter* Character;
+		FVector Location;
+		float HalfHeight;
+		float Radius;
+	};
+
+	/** cache the starts of the world if they aren't cached yet or one was destroyed */
+	void UpdateStarts(UWorld* World);
+
+	/** rebuild the pawn grid if it wasn't built this frame */
+	void UpdatePawns(UWorld* World);
+
+	/** add a pawn to the grid */
+	void AddPawn(ACharacter* Character, const FVector& Location, float HalfHeight, float Radius);
+
+	/**
+	 * Starts Player is allowed to use.
+	 * Filters are cached by team and bot flag, the only things IsSpawnpointAllowed looks at.
+	 */
+	const TArray<int32>& GetAllowedStarts(AShooterGameMode* GameMode, AController* Player);
+
+	/** check if a pawn of the template's size would overlap a pawn at Location */
+	bool IsOccupied(const FVector& Location, const ACharacter* PawnTemplate) const;
+
+	/** number of live enemies of Player within the danger radius */
+	int32 GetDanger(const FVector& Location, AController* Player) const;
+
+	/** cell containing a location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** cached starts, in actor iterator order */
+	TArray<FStartInfo> Starts;
+
+	/** "Play from Here" start, always used when it exists */
+	TWeakObjectPtr<APlayerStart> PIEStart;
+
+	/** are the cached starts up to date? */
+	bool bHasStarts;
+
+	/** allowed start indices by team and bot flag */
+	TMap<FIntPoint, TArray<int32>> AllowedStarts;
+
+	/** pawns and claimed starts, only valid in the frame the grid was built */
+	TArray<FPawnEntry> Pawns;
+
+	/** pawn indices per cell */
+	TMap<FIntPoint, TArray<int32>> PawnCells;
+
+	/** largest pawn radius in the grid */
+	float MaxPawnRadius;
+
+	/** cell size the grid was built with */
+	float CellSize;
+
+	/** frame the grid was built in */
+	uint64 LastUpdateFrame;
+};
@@ -16,10 +16,16 @@ class AShooterPickup : public AActor
 	/** check if pawn can use this pickup */
 	virtual bool CanBePickedUp(class AShooterCharacter* TestPawn) const;
 
+	/** what this pickup gives, used to bucket pickups for bot queries */
+	virtual UClass* GetPickupType() const;
+
 protected:
 	/** initial setup */
 	virtual void BeginPlay() override;
 
+	/** remove from the pickup registry */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 private:
 	/** FX component */
 	UPROPERTY(VisibleDefaultsOnly, Category=Effects)
@@ -66,6 +72,9 @@ protected:
 	/** handle touches */
 	void PickupOnTouch(class AShooterCharacter* Pawn);
 
+	/** [server] report active state to the pickup registry */
+	void UpdateRegistry();
+
 	/** show and enable pickup */
 	virtual void RespawnPickup();
 
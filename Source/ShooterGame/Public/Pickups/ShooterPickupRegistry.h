@@ -0,0 +1,98 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+class AShooterCharacter;
+class AShooterPickup;
+
+/**
+ * Pickups of a world bucketed by what they give and by grid cell, so bots find the nearest available one without walking every pickup.
+ * Pickups don't move, they register once and report when they are picked up or respawn.
+ */
+class FShooterPickupRegistry
+{
+public:
+
+	FShooterPickupRegistry();
+
+	/** add a pickup, TypeClass is what it gives (weapon class for ammo) */
+	void RegisterPickup(AShooterPickup* Pickup, UClass* TypeClass, bool bActive);
+
+	/** remove a pickup */
+	void UnregisterPickup(AShooterPickup* Pickup);
+
+	/** pickup was picked up or respawned */
+	void SetPickupActive(AShooterPickup* Pickup, bool bActive);
+
+	/**
+	 * Finds the active pickup of TypeClass (or a child of it) ForPawn can use with the lowest travel cost from Location.
+	 * Travel cost comes from cached navmesh path costs of the nearest candidates, straight line distance if there is no path.
+	 */
+	AShooterPickup* FindNearestPickup(UWorld* World, UClass* TypeClass, const FVector& Location, AShooterCharacter* ForPawn);
+
+	/** compare queries against a linear scan on a synthetic registry, logs the timings */
+	static void RunBenchmark(UWorld* World, int32 NumPickups, int32 NumBots);
+
+private:
+
+	struct FEntry
+	{
+		/** registered pickup, NULL for synthetic entries */
+		AShooterPickup* Pickup;
+		FVector Location;
+		bool bActive;
+	};
+
+	struct FBucket
+	{
+		/** what the pickups of this bucket give */
+		UClass* TypeClass;
+
+		/** pickups, removed ones stay as inactive holes */
+		TArray<FEntry> Entries;
+
+		/** entry indices per cell */
+		TMap<FIntPoint, TArray<int32>> Cells;
+
+		/** bounds of occupied cells, limits the ring search */
+		FIntPoint MinCell;
+		FIntPoint MaxCell;
+
+		int32 NumActive;
+	};
+
+	struct FCandidate
+	{
+		const FEntry* Entry;
+		float DistSq;
+	};
+
+	struct FCachedPathCost
+	{
+		float Cost;
+		float Time;
+	};
+
+	/** add an entry to the bucket of TypeClass */
+	void AddEntry(AShooterPickup* Pickup, UClass* TypeClass, const FVector& Location, bool bActive);
+
+	/** nearest active entries of TypeClass by straight line distance, nearest first */
+	void FindCandidates(UClass* TypeClass, const FVector& Location, AShooterCharacter* ForPawn, int32 MaxResults, TArray<FCandidate, TInlineAllocator<16>>& OutCandidates) const;
+
+	/** navmesh path cost from Location to a pickup, cached per start cell */
+	float GetPathCost(UWorld* World, const FVector& Location, const FEntry& Entry);
+
+	/** cell containing a location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	TArray<FBucket> Buckets;
+
+	/** bucket and entry index of every registered pickup */
+	TMap<AShooterPickup*, FIntPoint> PickupSlots;
+
+	/** path costs by start cell and pickup */
+	TMap<TPair<FIntVector, AShooterPickup*>, FCachedPathCost> PathCostCache;
+
+	/** cell size, fixed once the first pickup registered */
+	float CellSize;
+};
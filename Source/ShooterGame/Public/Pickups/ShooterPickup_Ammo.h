@@ -19,6 +19,9 @@ class AShooterPickup_Ammo : public AShooterPickup
 
 	bool IsForWeapon(UClass* WeaponClass);
 
+	/** ammo pickups are bucketed by the weapon they give ammo for */
+	virtual UClass* GetPickupType() const override;
+
 protected:
 
 	/** how much ammo does it give? */
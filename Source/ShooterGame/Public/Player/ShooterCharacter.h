@@ -7,6 +7,36 @@
 
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnShooterCharacterEquipWeapon, AShooterCharacter*, AShooterWeapon* /* new */);
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnShooterCharacterUnEquipWeapon, AShooterCharacter*, AShooterWeapon* /* old */);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnShooterCharacterInventoryChange, AShooterCharacter*);
+
+/** Cached result of the pause replication line of sight test of a pawn, for a single viewer */
+struct FPauseReplicationVisibility
+{
+	/** world time at which the result should be refreshed */
+	float NextRefreshTime = 0.f;
+
+	/** id of the async trace request in flight, 0 if none */
+	uint32 PendingRequestId = 0;
+
+	/** number of traces of the pending request still in flight */
+	int32 PendingTraceCount = 0;
+
+	/** whether any trace of the pending request reached the viewer */
+	bool bPendingVisible = false;
+
+	/** last known result */
+	bool bPaused = false;
+};
+
+/** [server] hit box of a character at a point in time, used to verify client side hits against where the client saw the character */
+struct FShooterHitSnapshot
+{
+	/** world time the snapshot was recorded at */
+	float Time = -1.f;
+
+	/** world space bounds of the hit mesh */
+	FBox HitBox = FBox(ForceInit);
+};
 
 UENUM(BlueprintType)
 enum ECosmeticEfx
@@ -39,6 +69,12 @@ class AShooterCharacter : public ACharacter
 	/** [server] perform PlayerState related setup */
 	virtual void PossessedBy(class AController* C) override;
 
+	/** [server] controller no longer possesses this pawn */
+	virtual void UnPossessed() override;
+
+	/** [client] controller changed */
+	virtual void OnRep_Controller() override;
+
 	/** [client] perform PlayerState related setup */
 	virtual void OnRep_PlayerState() override;
 
@@ -228,6 +264,9 @@ class AShooterCharacter : public ACharacter
 	/** Global notification when a character un-equips a weapon. Needed for replication graph. */
 	SHOOTERGAME_API static FOnShooterCharacterUnEquipWeapon NotifyUnEquipWeapon;
 
+	/** Global notification when a weapon enters or leaves a character's inventory. Needed for replication graph. */
+	SHOOTERGAME_API static FOnShooterCharacterInventoryChange NotifyInventoryChange;
+
 	/** get weapon attach point */
 	FName GetWeaponAttachPoint() const;
 
@@ -284,6 +323,18 @@ class AShooterCharacter : public ACharacter
 	/** Update the team color of all player meshes. */
 	void UpdateTeamColorsAllMIDs();
 
+	/**
+	* [server] Get the hit box of this character as it was at a given time, interpolated from the hit history.
+	*
+	* @param	Time		World time to rewind to. Clamped to the recorded range.
+	* @param	OutHitBox	Hit box at that time.
+	* @returns false if there is no history (e.g. standalone, or just spawned)
+	*/
+	bool GetRewoundHitBox(float Time, FBox& OutHitBox) const;
+
+	/** [server] check if hit boxes are being recorded for this character */
+	bool HasHitHistory() const { return HitHistoryHead != INDEX_NONE; }
+
 private:
 
 	/** pawn mesh: 1st person view */
@@ -493,8 +544,50 @@ protected:
 	UFUNCTION(reliable, server, WithValidation)
 	void ServerSetRunning(bool bNewRunning, bool bToggle);
 
+	/** Number of points built by BuildPauseReplicationCheckPoints */
+	static const int32 NumPauseReplicationCheckPoints = 8;
+
+	/** Number of snapshots kept in HitHistory */
+	static const int32 HitHistorySize = 64;
+
+	/** [server] ring buffer of recent hit boxes, written every tick */
+	FShooterHitSnapshot HitHistory[HitHistorySize];
+
+	/** [server] index of the most recent entry in HitHistory, INDEX_NONE if empty */
+	int32 HitHistoryHead;
+
+	/** [server] record the current hit box into HitHistory */
+	void RecordHitHistory();
+
+	/** [server] forget all snapshots, e.g. when recording stops */
+	void ClearHitHistory();
+
+	/** Publishes whether this pawn is locally controlled to USoundNodeLocalPlayer. Only posts to the audio thread when the value changes. */
+	void UpdateLocallyControlledActorCache();
+
+	/** last value published by UpdateLocallyControlledActorCache. Starts false, which is also what the audio side assumes for unknown actors. */
+	uint8 bPublishedLocallyControlled : 1;
+
 	/** Builds list of points to check for pausing replication for a connection*/
-	void BuildPauseReplicationCheckPoints(TArray<FVector>& RelevancyCheckPoints);
+	void BuildPauseReplicationCheckPoints(FVector (&RelevancyCheckPoints)[NumPauseReplicationCheckPoints]) const;
+
+	/** Synchronously traces the check points against ViewLocation, returns true as soon as one of them is visible */
+	bool IsVisibleFromViewPoint(const FVector& ViewLocation, const FCollisionQueryParams& CollisionParams) const;
+
+	/** Issues async traces to refresh the cached visibility of this pawn for a viewer */
+	void RequestAsyncPauseReplicationTest(FPauseReplicationVisibility& Visibility, const FVector& ViewLocation, const FCollisionQueryParams& CollisionParams);
+
+	/** Async trace completion for RequestAsyncPauseReplicationTest */
+	void OnPauseReplicationTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/** [server] per viewer visibility used by IsReplicationPausedForConnection */
+	TMap<TWeakObjectPtr<APlayerController>, FPauseReplicationVisibility> PauseReplicationCache;
+
+	/** [server] delegate for async pause replication traces */
+	FTraceDelegate PauseReplicationTraceDelegate;
+
+	/** [server] last id handed out to an async pause replication request */
+	uint32 LastPauseReplicationRequestId;
 
 protected:
 	/** Returns Mesh1P subobject **/
@@ -32,6 +32,18 @@ class UShooterCharacterMovement : public UCharacterMovementComponent
 	/** This function set the variables for calling the jetpack */
 	void ExecWallRun(bool useRequest);
 
+	/** [server] Apply the ability inputs packed in a client move */
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+
+	/** [client] Count corrections received from the server */
+	virtual void OnClientCorrectionReceived(class FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode) override;
+
+	/** [server] Count client moves that needed a correction */
+	virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+
+	/** Number of position corrections sent (server) or received (client) for this character */
+	int32 GetNumCorrections() const { return NumCorrections; }
+
 private:
 
 	/** The shooter character associated */
@@ -53,6 +65,30 @@ private:
 		
 	/** Actual fuel */
 	float ActualFuel;
+
+	/** Move time not yet simulated by the fixed step fuel model */
+	float FuelStepRemainder = 0.0f;
+
+	/** JetpackCurve sampled at even steps, built in BeginPlay */
+	TArray<float> JetpackCurveTable;
+
+	/** Curve time of the first and last JetpackCurveTable sample */
+	float JetpackCurveMinTime = 0.0f;
+	float JetpackCurveMaxTime = 0.0f;
+
+	/** [server] The owning client has to get the fuel after the current move */
+	bool bPendingFuelCorrection = false;
+
+	/** [server] World time of the last fuel correction sent */
+	float LastFuelCorrectionTime = -1.0f;
+
+	/** [client] Fuel after each of the last moves, to compare with server corrections */
+	struct FFuelHistoryEntry {
+		float TimeStamp;
+		float Fuel;
+	};
+	TArray<FFuelHistoryEntry> FuelHistory;
+	int32 FuelHistoryHead = 0;
 	
 	/** Is the character running on a wall? */
 	bool bRunningOnWall = false;
@@ -69,6 +105,21 @@ private:
 	/** Time handler used for abilities */
 	FTimerHandle AbilityTimerHandle;
 
+	/** Position corrections sent (server) or received (client) */
+	int32 NumCorrections = 0;
+
+	/** Last wall hit found by IsTouchingAround() */
+	FHitResult CachedWallHit;
+
+	/** Character location when CachedWallHit was swept */
+	FVector CachedWallProbeLocation;
+
+	/** Is CachedWallHit usable? */
+	bool bHasCachedWallHit = false;
+
+	/** Query params for the wall sweep, built once in BeginPlay */
+	FCollisionQueryParams WallProbeParams;
+
 	virtual float GetMaxSpeed() const override;
 	
 	virtual void OnMovementUpdated(float DeltaSeconds, const FVector & OldLocation, const FVector & OldVelocity) override;
@@ -84,11 +135,30 @@ private:
 	/** Manage the wall run mechanic's physics */
 	void PhysWallRun(float deltaTime, int32 Iterations);
 	
-	/** Recharge the jetpack fuel */
-	void RecoverJetpackFuel(float DeltaTime);
+	/** Consume or recharge the jetpack fuel in fixed steps of move time, so client and server get the same result */
+	void SimulateJetpackFuel(float DeltaSeconds);
 
-	/** Check if character is touching in the specified direction */
-	FHitResult IsTouchingAround();
+	/** Sample JetpackCurve into JetpackCurveTable */
+	void BuildJetpackCurveTable();
+
+	/** Evaluate the jetpack curve from JetpackCurveTable */
+	float EvaluateJetpackCurve(float Time) const;
+
+	/** Fuel as a byte, 255 is a full tank */
+	uint8 QuantizeFuel(float Fuel) const;
+
+	/** [server] Send the fuel to the owning client after the current move */
+	void RequestFuelCorrection();
+
+	/** [client] Server fuel after the move with TimeStamp, only sent when the client may have diverged */
+	UFUNCTION(Client, Unreliable)
+	void ClientAdjustJetpackFuel(float TimeStamp, uint8 QuantizedFuel, bool bServerFuelOver);
+
+	/** Check if character is touching in the specified direction. Reuses the last wall hit until the character moved WallContactRecheckDistance */
+	const FHitResult& IsTouchingAround();
+
+	/** Forget the cached wall, the next IsTouchingAround() sweeps again */
+	void ResetWallContact();
 
 	/** Function used for enabling the use of ability */
 	void EnableAbility();
@@ -163,6 +233,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ability|Wall Run")
 	float DistanceFromWall = 5.0f;
 
+	/** Distance the character can move along a wall before checking the wall contact again */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ability|Wall Run")
+	float WallContactRecheckDistance = 10.0f;
+
 	/** Set the upper force after a wall run */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ability|Wall Run")
 	float LaunchUpperVelocity = 1000.0f;
@@ -174,18 +248,6 @@ public:
 
 	void SetWallRun(bool useRequest);
 
-	/**	This function is called from client to server */
-	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable)
-	void ServerTeleport(bool useRequest);
-
-	/**	This function is called from client to server */
-	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable)
-	void ServerJetpack(bool useRequest);
-
-	/**	This function is called from client to server */
-	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable)
-	void ServerWallRun(bool useRequest);
-
 	UFUNCTION(BlueprintCallable, Category = "Jetpack")
 	float RetrieveActualFuel();
 
@@ -218,9 +280,24 @@ public:
 	/** Called before ClientUpdatePosition uses this SavedMove to make a predictive correction */
 	virtual void PrepMoveFor(ACharacter* Character) override;
 
+	/** Pack the ability inputs so they are sent with the move */
+	virtual uint8 GetCompressedFlags() const override;
+
+	/** Moves can't be combined if an ability input changed between them */
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+
+	/** Rewind the jetpack state to the start of the pending move, so its time isn't simulated twice */
+	virtual void CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation) override;
+
 	bool savedUseTeleport = false;
 	bool savedUseJetpack = false;
 	bool savedUseWallRun = false;
+
+	/** Jetpack state at the start of the move, restored when the move is replayed */
+	float savedActualFuel = 0.0f;
+	float savedFuelStepRemainder = 0.0f;
+	float savedJetpackElapsedTime = 0.0f;
+	bool savedFuelOver = false;
 };
 
 /** Network data representation on the client. */
@@ -29,4 +29,8 @@ class UShooterCheatManager : public UCheatManager
 
 	UFUNCTION(exec)
 	void SpawnBot();
+
+	/** Spawns Count bots at once, e.g. to profile "stat ShooterGame" with a full server */
+	UFUNCTION(exec)
+	void SpawnBots(int32 Count);
 };
@@ -21,11 +21,14 @@ class UBehaviorTreeComponent;
 DECLARE_LOG_CATEGORY_EXTERN(LogShooter, Log, All);
 DECLARE_LOG_CATEGORY_EXTERN(LogShooterWeapon, Log, All);
 
+DECLARE_STATS_GROUP(TEXT("ShooterGame"), STATGROUP_ShooterGame, STATCAT_Advanced);
+
 /** when you modify this, please note that this information can be saved with instances
  * also DefaultEngine.ini [/Script/Engine.CollisionProfile] should match with this list **/
 #define COLLISION_WEAPON		ECC_GameTraceChannel1
 #define COLLISION_PROJECTILE	ECC_GameTraceChannel2
 #define COLLISION_PICKUP		ECC_GameTraceChannel3
+#define COLLISION_WALLRUN		ECC_GameTraceChannel4
 
 #define MAX_PLAYER_NAME_LENGTH 16
 
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Sound/SoundNode.h"
+#include "Templates/Atomic.h"
 #include "SoundNodeLocalPlayer.generated.h"
 
 /**
@@ -22,13 +23,29 @@ class USoundNodeLocalPlayer : public USoundNode
 #endif
 	// End USoundNode interface.
 
-	static TMap<uint32, bool>& GetLocallyControlledActorCache()
-	{
-		check(IsInAudioThread());
-		return LocallyControlledActorCache;
-	}
+	/** [game thread] Publish whether the actor with this unique id is locally controlled. Visible to the audio thread without a command round trip. */
+	static void SetLocallyControlled(uint32 ActorID, bool bLocallyControlled);
+
+	/** [game thread] Forget an actor, e.g. when it is destroyed */
+	static void RemoveLocallyControlled(uint32 ActorID);
+
+	/** [any thread] Check if the actor with this unique id was published as locally controlled */
+	static bool IsLocallyControlled(uint32 ActorID);
 
 private:
 
-	static TMap<uint32, bool> LocallyControlledActorCache;
-};
+	/**
+	 * Fixed size open addressed table. Each slot is a single 64 bit word holding the actor id and its state, so readers never see a torn entry.
+	 * Only the game thread writes. Removed entries keep their id (tombstone) so probe chains stay intact for concurrent readers, and are reused
+	 * when the same or a new id is added. Tombstones at the end of a chain are emptied again, and no probe is longer than LocallyControlledMaxProbe.
+	 */
+	static const uint32 LocallyControlledTableSize = 4096;
+	static const uint32 LocallyControlledMaxProbe = 64;
+	static TAtomic<uint64> LocallyControlledTable[LocallyControlledTableSize];
+
+	/** Returns the slot holding ActorID, or INDEX_NONE. If OutFreeSlot is given it receives the first reusable slot on the probe chain. */
+	static int32 FindLocallyControlledSlot(uint32 ActorID, int32* OutFreeSlot);
+
+	/** Empties the tombstone at SlotIndex and the ones before it if no probe chain continues past them */
+	static void ReclaimTombstones(int32 SlotIndex);
+};
\ No newline at end of file
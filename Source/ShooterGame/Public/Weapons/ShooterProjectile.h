@@ -9,15 +9,54 @@
 class UProjectileMovementComponent;
 class USphereComponent;
 
+/** Launch of a projectile moved by AShooterProjectileManager, clients extrapolate from it */
+USTRUCT()
+struct FShooterProjectileLaunch
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** location at launch */
+	UPROPERTY()
+	FVector_NetQuantize Origin;
+
+	/** direction of flight */
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction;
+
+	/** speed, 0 if the projectile moves with its own movement component */
+	UPROPERTY()
+	float Speed;
+
+	/** server world time of the launch */
+	UPROPERTY()
+	float ServerLaunchTime;
+
+	FShooterProjectileLaunch()
+		: Origin(ForceInitToZero)
+		, Direction(ForceInitToZero)
+		, Speed(0.0f)
+		, ServerLaunchTime(0.0f)
+	{
+	}
+};
+
 // 
 UCLASS(Abstract, Blueprintable)
 class AShooterProjectile : public AActor
 {
 	GENERATED_UCLASS_BODY()
 
+	friend class AShooterProjectileManager;
+
 	/** initial setup */
 	virtual void PostInitializeComponents() override;
 
+	/** [server] hand straight line projectiles to the projectile manager */
+	virtual void BeginPlay() override;
+
+	/** stop being moved by the projectile manager */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** setup velocity */
 	void InitVelocity(FVector& ShootDirection);
 
@@ -25,6 +64,21 @@ class AShooterProjectile : public AActor
 	UFUNCTION()
 	void OnImpact(const FHitResult& HitResult);
 
+	/** [server] spawn a projectile that goes back to the pool instead of being destroyed; prewarmed ones start hidden and without collision */
+	static AShooterProjectile* SpawnPooled(UWorld* World, TSubclassOf<AShooterProjectile> ProjectileClass, const FTransform& SpawnTM, bool bPrewarm = false);
+
+	/** [server] fire a projectile taken from the pool */
+	void ActivateFromPool(const FTransform& SpawnTM, AActor* InOwner, APawn* InInstigator, FVector& ShootDirection);
+
+	/** [server] hide the projectile and make it dormant until it is fired again */
+	void DeactivateToPool();
+
+	/** return pooled projectiles to the pool */
+	virtual void LifeSpanExpired() override;
+
+	/** [server] should the projectile go back to the pool instead of being destroyed? */
+	void SetPooled(bool bInPooled) { bPooled = bInPooled; }
+
 private:
 	/** movement component */
 	UPROPERTY(VisibleDefaultsOnly, Category=Projectile)
@@ -52,10 +106,46 @@ protected:
 	UPROPERTY(Transient, ReplicatedUsing=OnRep_Exploded)
 	bool bExploded;
 
+	/** where the projectile exploded, clients can't rely on their extrapolated location */
+	UPROPERTY(Transient, Replicated)
+	FVector_NetQuantize ExplodedLocation;
+
+	/** surface normal where the projectile exploded */
+	UPROPERTY(Transient, Replicated)
+	FVector_NetQuantizeNormal ExplodedNormal;
+
+	/** is this projectile owned by the pool? */
+	bool bPooled;
+
+	/** incremented each time the projectile is fired from the pool */
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_PoolActivation)
+	uint8 PoolActivation;
+
 	/** [client] explosion happened */
 	UFUNCTION()
 	void OnRep_Exploded();
 
+	/** [client] projectile was fired again from the pool */
+	UFUNCTION()
+	void OnRep_PoolActivation();
+
+	/** launch replicated instead of movement when moved by the projectile manager */
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_Launch)
+	FShooterProjectileLaunch Launch;
+
+	/** [client] start extrapolating from the launch */
+	UFUNCTION()
+	void OnRep_Launch();
+
+	/** is the projectile moved by the projectile manager? */
+	bool IsBatched() const { return Launch.Speed > 0.0f; }
+
+	/** [server] let the projectile manager move this projectile if it flies in a straight line */
+	void TryStartBatchedFlight();
+
+	/** restart movement and effects for a pooled projectile */
+	void ResetForReuse();
+
 	/** trigger explosion */
 	void Explode(const FHitResult& Impact);
 
@@ -0,0 +1,63 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GameFramework/Actor.h"
+#include "ShooterProjectileManager.generated.h"
+
+class AShooterProjectile;
+
+/**
+ * Moves all straight line projectiles of a world in fixed steps, instead of each projectile ticking its own movement component.
+ * The server sweeps for impacts, clients extrapolate from the replicated launch and only stop at level geometry.
+ */
+UCLASS(NotPlaceable, Transient)
+class AShooterProjectileManager : public AActor
+{
+	GENERATED_UCLASS_BODY()
+
+	/** get the manager of a world, spawning it on first use */
+	static AShooterProjectileManager* Get(UWorld* World);
+
+	/** get the manager of a world, NULL if it wasn't spawned */
+	static AShooterProjectileManager* Find(UWorld* World);
+
+	/** check if projectiles should be simulated by the manager */
+	static bool IsEnabled();
+
+	/** start moving a projectile */
+	void AddProjectile(AShooterProjectile* Projectile, const FVector& Location, const FVector& Velocity, float Radius);
+
+	/** stop moving a projectile, safe to call while simulating */
+	void RemoveProjectile(AShooterProjectile* Projectile);
+
+	/** advance all projectiles */
+	virtual void Tick(float DeltaSeconds) override;
+
+private:
+
+	/** move all projectiles one step, sweeping for impacts */
+	void SimulateStep(float StepTime);
+
+	/** drop projectiles removed during the step */
+	void CompactRemoved();
+
+	/** projectiles, NULL once removed until the arrays are compacted */
+	UPROPERTY(Transient)
+	TArray<AShooterProjectile*> Projectiles;
+
+	/** simulated location of each projectile */
+	TArray<FVector> Locations;
+
+	/** velocity of each projectile */
+	TArray<FVector> Velocities;
+
+	/** collision radius of each projectile */
+	TArray<float> Radii;
+
+	/** time not simulated yet */
+	float StepRemainder;
+
+	/** a projectile was removed and the arrays need compacting */
+	bool bHasRemoved;
+};
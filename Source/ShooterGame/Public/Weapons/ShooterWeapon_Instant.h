@@ -7,19 +7,115 @@
 
 class AShooterImpactEffect;
 
+/** Shots fired in the current burst, replicated so remote clients can rebuild every shot from one seed */
 USTRUCT()
-struct FInstantHitInfo
+struct FInstantShotStream
 {
 	GENERATED_USTRUCT_BODY()
 
+	/** origin of the latest shot */
 	UPROPERTY()
-	FVector Origin;
+	FVector_NetQuantize Origin;
 
+	/** seed of the first shot in the stream, shot N uses GetShotSeed(BaseSeed, N) */
+	UPROPERTY()
+	int32 BaseSeed;
+
+	/** number of shots in the stream, wraps around */
+	UPROPERTY()
+	uint16 ShotCount;
+
+	/** spread of the latest shot */
 	UPROPERTY()
 	float ReticleSpread;
 
+	FInstantShotStream()
+		: Origin(ForceInitToZero)
+		, BaseSeed(0)
+		, ShotCount(0)
+		, ReticleSpread(0.0f)
+	{
+	}
+
+	/**
+	 * Random seed of the shot after the one using Seed. Hashed so consecutive shots don't get correlated FRandomStream draws,
+	 * and chained so the seed of any shot is also the base of the shots after it, a stream can start anywhere in a burst.
+	 */
+	static int32 GetNextShotSeed(int32 Seed)
+	{
+		uint32 Hash = (uint32)Seed + 0x9E3779B9u;
+		Hash = (Hash ^ (Hash >> 16)) * 0x85EBCA6Bu;
+		Hash = (Hash ^ (Hash >> 13)) * 0xC2B2AE35u;
+		return (int32)(Hash ^ (Hash >> 16));
+	}
+
+	/** random seed of a shot in a stream, GetShotSeed(Base, 0) == Base */
+	static int32 GetShotSeed(int32 InBaseSeed, int32 ShotIndex)
+	{
+		int32 Seed = InBaseSeed;
+		for (int32 Idx = 0; Idx < ShotIndex; Idx++)
+		{
+			Seed = GetNextShotSeed(Seed);
+		}
+		return Seed;
+	}
+};
+
+/** One shot in a batched hit notify, quantized for the client to server RPC */
+USTRUCT()
+struct FInstantShotInfo
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** actor hit by the shot, sent as a net GUID */
+	UPROPERTY()
+	AActor* HitActor;
+
+	/** impact location (only sent for blocking hits) */
+	UPROPERTY()
+	FVector_NetQuantize ImpactPoint;
+
+	/** impact normal (only sent for blocking hits) */
+	UPROPERTY()
+	FVector_NetQuantizeNormal ImpactNormal;
+
+	/** direction of the shot */
+	UPROPERTY()
+	FVector_NetQuantizeNormal ShootDir;
+
+	/** seed used for the spread cone */
 	UPROPERTY()
 	int32 RandomSeed;
+
+	/** spread used for the shot, sent with 0.01 degree precision */
+	UPROPERTY()
+	float ReticleSpread;
+
+	/** did the shot hit something */
+	UPROPERTY()
+	uint8 bBlockingHit : 1;
+
+	FInstantShotInfo()
+		: HitActor(nullptr)
+		, ImpactPoint(ForceInitToZero)
+		, ImpactNormal(ForceInitToZero)
+		, ShootDir(ForceInitToZero)
+		, RandomSeed(0)
+		, ReticleSpread(0.0f)
+		, bBlockingHit(false)
+	{
+	}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FInstantShotInfo> : public TStructOpsTypeTraitsBase2<FInstantShotInfo>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
 };
 
 USTRUCT()
@@ -63,6 +159,14 @@ struct FInstantWeaponData
 	UPROPERTY(EditDefaultsOnly, Category=HitVerification)
 	float AllowedViewDotHitDir;
 
+	/** hit verification: distance (uu) allowed outside the hit box of a character rewound to the time the client fired */
+	UPROPERTY(EditDefaultsOnly, Category=HitVerification)
+	float RewindHitLeeway;
+
+	/** hit verification: max time (seconds) the server will rewind characters to verify a hit */
+	UPROPERTY(EditDefaultsOnly, Category=HitVerification)
+	float MaxRewindTime;
+
 	/** defaults */
 	FInstantWeaponData()
 	{
@@ -75,6 +179,8 @@ struct FInstantWeaponData
 		DamageType = UDamageType::StaticClass();
 		ClientSideHitLeeway = 200.0f;
 		AllowedViewDotHitDir = 0.8f;
+		RewindHitLeeway = 30.0f;
+		MaxRewindTime = 0.4f;
 	}
 };
 
@@ -110,30 +216,89 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category=Effects)
 	FName TrailTargetParam;
 
-	/** instant hit notify for replication */
-	UPROPERTY(Transient, ReplicatedUsing=OnRep_HitNotify)
-	FInstantHitInfo HitNotify;
+	/** instant hit shots for replication */
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_ShotStream)
+	FInstantShotStream ShotStream;
+
+	/** [remote] base seed of the last simulated shot stream */
+	int32 SimulatedBaseSeed;
+
+	/** [remote] number of shots already simulated from the stream */
+	uint16 SimulatedShotCount;
+
+	/** [remote] seed of the next shot in the simulated stream */
+	int32 SimulatedNextSeed;
+
+	/** [server] seed a shot needs to continue ShotStream */
+	int32 StreamNextSeed;
+
+	/** [remote] was a shot stream received before? the first one may be an old burst of a weapon that just became relevant */
+	bool bReceivedShotStream;
 
 	/** current spread from continuous firing */
 	float CurrentFiringSpread;
 
+	/** [local] seed of the next shot in the current burst */
+	int32 BurstNextSeed;
+
+	/** [client] shots waiting to be sent in the next batched notify */
+	TArray<FInstantShotInfo> PendingShots;
+
+	/** [client] true if any pending shot needs the reliable notify */
+	uint8 bPendingShotsNeedReliable : 1;
+
+	/** [client] world time of the oldest pending shot */
+	float PendingShotsTime;
+
+	/** [client] end of frame hook used to flush pending shots */
+	FDelegateHandle PendingShotsFlushHandle;
+
 	//////////////////////////////////////////////////////////////////////////
 	// Weapon usage
 
 	/** server notified of hit from client to verify */
 	UFUNCTION(reliable, server, WithValidation)
-	void ServerNotifyHit(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread);
+	void ServerNotifyHit(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread, float ClientServerTime);
 
 	/** server notified of miss to show trail FX */
 	UFUNCTION(unreliable, server, WithValidation)
 	void ServerNotifyMiss(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread);
 
+	/** server notified of a batch of shots fired by the client, containing at least one hit to verify */
+	UFUNCTION(reliable, server, WithValidation)
+	void ServerNotifyShotBatch(const TArray<FInstantShotInfo>& Shots, float ClientServerTime);
+
+	/** server notified of a batch of missed shots to show trail FX */
+	UFUNCTION(unreliable, server, WithValidation)
+	void ServerNotifyMissBatch(const TArray<FInstantShotInfo>& Shots);
+
+	/** [server] verify and process shots from a batched notify, in the order they were fired */
+	void ProcessShotBatch(const TArray<FInstantShotInfo>& Shots, float ClientServerTime);
+
+	/** [client] add a shot to the pending batch instead of sending it right away */
+	void QueueShot(const FHitResult& Impact, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
+
+	/** [client] send all pending shots to the server */
+	void FlushPendingShots();
+
+	/** [client] end of frame hook, sends pending shots before the net driver flushes */
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
 	/** process the instant hit and notify the server if necessary */
 	void ProcessInstantHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
 
 	/** continue processing the instant hit, as if it has been confirmed by the server */
 	void ProcessInstantHit_Confirmed(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
 
+	/** [server] check if the hit actor keeps a hit history that VerifyRewoundHit can use */
+	bool CanVerifyRewoundHit(const FHitResult& Impact) const;
+
+	/** [server] verify a client side hit on a character against its hit box at the time the client fired */
+	bool VerifyRewoundHit(const FHitResult& Impact, float ClientServerTime) const;
+
+	/** [client] server world time as seen by this client, sent with hits so the server knows how far to rewind */
+	float GetClientServerTime() const;
+
 	/** check if weapon should deal damage to actor */
 	bool ShouldDealDamage(AActor* TestActor) const;
 
@@ -143,19 +308,34 @@ protected:
 	/** [local] weapon specific fire implementation */
 	virtual void FireWeapon() override;
 
+	/** [local] send pending shots before the server stops firing */
+	virtual void StopFire() override;
+
+	/** [local] pick a new seed for the shots of this burst */
+	virtual void OnBurstStarted() override;
+
 	/** [local + server] update spread on firing */
 	virtual void OnBurstFinished() override;
 
+	/** send pending shots and stop listening for end of frame */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 
 	//////////////////////////////////////////////////////////////////////////
 	// Effects replication
 	
+	/** [server] add a shot to the replicated stream, starting a new stream if it doesn't follow the last shot */
+	void AddShotToStream(const FVector& Origin, int32 RandomSeed, float ReticleSpread);
+
 	UFUNCTION()
-	void OnRep_HitNotify();
+	void OnRep_ShotStream();
 
 	/** called in network play to do the cosmetic fx  */
 	void SimulateInstantHit(const FVector& Origin, int32 RandomSeed, float ReticleSpread);
 
+	/** check if any local player views the scene from within MaxDistance of Location */
+	bool IsNearLocalView(const FVector& Location, float MaxDistance) const;
+
 	/** spawn effects for impact */
 	void SpawnImpactEffects(const FHitResult& Impact);
 
@@ -51,6 +51,9 @@ class AShooterWeapon_Projectile : public AShooterWeapon
 	/** apply config on projectile */
 	void ApplyWeaponConfig(FProjectileWeaponData& Data);
 
+	/** [server] fill the projectile pool */
+	virtual void BeginPlay() override;
+
 protected:
 
 	virtual EAmmoType GetAmmoType() const override